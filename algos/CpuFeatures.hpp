@@ -0,0 +1,22 @@
+#ifndef __CPUFEATURES_HPP__
+#define __CPUFEATURES_HPP__
+
+/**
+ *  CpuFeatures - instruction sets of the running CPU, detected once at startup by CPUID.
+ *  Kernels compiled with `__attribute__((target(...)))` are selected by these flags,
+ *  so one binary runs on any x86-64 machine.
+ */
+struct CpuFeatures {
+    bool avx2, avx512f, avx512vpopcntdq;
+};
+
+inline const CpuFeatures cpuFeatures = [](){
+    __builtin_cpu_init();
+    return CpuFeatures{
+        (bool)__builtin_cpu_supports("avx2"),
+        (bool)__builtin_cpu_supports("avx512f"),
+        (bool)__builtin_cpu_supports("avx512vpopcntdq")
+    };
+}();
+
+#endif // __CPUFEATURES_HPP__
@@ -0,0 +1,604 @@
+#ifndef __COMPRESSEDBITSET_HPP__
+#define __COMPRESSEDBITSET_HPP__
+#include "bitset.hpp"
+
+/**
+ *  CompressedBitsetContainer - set of 16-bit values in one of three representations:
+ *  Array (sorted values, up to 4096 items), Bitmap (1024 words) or Run (sorted
+ *  segments [first, last]). Point updates keep Array/Bitmap by cardinality and turn
+ *  Run into one of them, optimize() picks the smallest representation.
+ */
+struct CompressedBitsetContainer {
+
+    enum Type : uint8_t { Array, Bitmap, Run };
+
+    static constexpr int Bits = 1 << 16, Words = Bits / 64, MaxArray = 4096;
+
+    using Segment = std::pair<uint16_t, uint16_t>;
+
+    Type type{Array};
+
+    int card{};
+
+    std::vector<uint16_t> arr;
+
+    std::vector<uint64_t> words;
+
+    std::vector<Segment> runs;
+
+    size_t memoryUsage() const {
+        return sizeof(*this) + arr.capacity() * sizeof(uint16_t)
+             + words.capacity() * sizeof(uint64_t) + runs.capacity() * sizeof(Segment);
+    }
+
+    // Index of first segment with first > x:
+    auto runAfter(int x) const {
+        return std::upper_bound(runs.begin(), runs.end(), Segment((uint16_t)x, (uint16_t)(Bits-1)));
+    }
+
+    bool test(int x) const {
+        switch (type) {
+            case Array: return std::binary_search(arr.begin(), arr.end(), (uint16_t)x);
+            case Bitmap: return (words[x/64] >> x % 64) & 1;
+            default: {
+                auto it = runAfter(x);
+                return it != runs.begin() && (--it)->second >= x;
+            }
+        }
+    }
+
+    // First value >= x or Bits if there is no such value:
+    int lowerBound(int x) const {
+        if (x >= Bits) return Bits;
+        switch (type) {
+            case Array: {
+                auto it = std::lower_bound(arr.begin(), arr.end(), (uint16_t)x);
+                return it == arr.end() ? Bits : *it;
+            }
+            case Bitmap: {
+                const int g = x / 64;
+                if (const auto w = (words[g] >> x % 64); w)
+                    return x + __builtin_ctzll(w);
+                const int h = g + 1 + firstNonZero(words.data() + g + 1, Words - g - 1);
+                return h < Words ? h * 64 + __builtin_ctzll(words[h]) : Bits;
+            }
+            default: {
+                auto it = runAfter(x);
+                if (it != runs.begin() && std::prev(it)->second >= x)
+                    return x;
+                return it == runs.end() ? Bits : it->first;
+            }
+        }
+    }
+
+    template<typename F>
+    void forEach(F f) const {
+        switch (type) {
+            case Array: for (int x : arr) f(x); break;
+            case Bitmap:
+                for (int g = 0; g < Words; g++)
+                    for (auto w = words[g]; w; w &= w - 1)
+                        f(g * 64 + __builtin_ctzll(w));
+                break;
+            default:
+                for (auto [lo, hi] : runs)
+                    for (int x = lo; x <= hi; x++)
+                        f(x);
+        }
+    }
+
+    // Set bits [lo, hi] in array of words:
+    static void setRange(uint64_t *w, int lo, int hi) {
+        const int gl = lo / 64, gh = hi / 64;
+        const uint64_t ml = ~0ULL << lo % 64, mh = ~0ULL >> (63 - hi % 64);
+        if (gl == gh) { w[gl] |= ml & mh; return; }
+        w[gl] |= ml;
+        std::fill(w + gl + 1, w + gh, ~0ULL);
+        w[gh] |= mh;
+    }
+
+    // Copy of content as bitmap:
+    std::vector<uint64_t> bitmap() const {
+        if (type == Bitmap) return words;
+        std::vector<uint64_t> w(Words);
+        if (type == Array) {
+            for (int x : arr) w[x/64] |= 1ULL << x % 64;
+        } else {
+            for (auto [lo, hi] : runs) setRange(&w[0], lo, hi);
+        }
+        return w;
+    }
+
+    std::vector<uint16_t> values() const {
+        if (type == Array) return arr;
+        std::vector<uint16_t> res;
+        res.reserve(card);
+        forEach([&](int x){ res.push_back((uint16_t)x); });
+        return res;
+    }
+
+    int countRuns() const {
+        switch (type) {
+            case Array: {
+                int res = 0;
+                for (int i = 0; i < (int)arr.size(); i++)
+                    res += (i == 0 || arr[i] != arr[i-1] + 1);
+                return res;
+            }
+            case Bitmap: {
+                int res = 0; uint64_t carry = 0;
+                for (auto w : words) {
+                    res += __builtin_popcountll(w & ~((w << 1) | carry));
+                    carry = w >> 63;
+                }
+                return res;
+            }
+            default: return (int)runs.size();
+        }
+    }
+
+    void clearStorage() {
+        std::vector<uint16_t>().swap(arr);
+        std::vector<uint64_t>().swap(words);
+        std::vector<Segment>().swap(runs);
+    }
+
+    void toArray() {
+        if (type == Array) return;
+        auto v = values();
+        clearStorage();
+        arr = std::move(v);
+        type = Array;
+    }
+
+    void toBitmap() {
+        if (type == Bitmap) return;
+        auto w = bitmap();
+        clearStorage();
+        words = std::move(w);
+        type = Bitmap;
+    }
+
+    void toRun() {
+        if (type == Run) return;
+        std::vector<Segment> r;
+        r.reserve(countRuns());
+        forEach([&](int x){
+            if (r.empty() || r.back().second + 1 != x) r.emplace_back(x, x);
+            else r.back().second = (uint16_t)x;
+        });
+        clearStorage();
+        runs = std::move(r);
+        type = Run;
+    }
+
+    // Switch to the representation with the smallest memory:
+    void optimize() {
+        const size_t arrBytes = 2 * (size_t)card, mapBytes = 8 * Words;
+        const size_t runBytes = 4 * (size_t)countRuns();
+        if (runBytes < std::min(arrBytes, mapBytes)) toRun();
+        else if (arrBytes <= mapBytes) toArray();
+        else toBitmap();
+    }
+
+    // Point updates, return true if content was changed:
+    bool set(int x) {
+        if (type == Run) { if (test(x)) return false; card <= MaxArray ? toArray() : toBitmap(); }
+        if (type == Bitmap) {
+            uint64_t &w = words[x/64];
+            if ((w >> x % 64) & 1) return false;
+            w |= 1ULL << x % 64;
+        } else {
+            auto it = std::lower_bound(arr.begin(), arr.end(), (uint16_t)x);
+            if (it != arr.end() && *it == x) return false;
+            arr.insert(it, (uint16_t)x);
+            if (card + 1 > MaxArray) toBitmap();
+        }
+        card++;
+        return true;
+    }
+
+    bool reset(int x) {
+        if (!test(x)) return false;
+        if (type == Run) card <= MaxArray ? toArray() : toBitmap();
+        if (type == Bitmap) {
+            words[x/64] &= ~(1ULL << x % 64);
+            card--;
+            if (card <= MaxArray) toArray();
+        } else {
+            arr.erase(std::lower_bound(arr.begin(), arr.end(), (uint16_t)x));
+            card--;
+        }
+        return true;
+    }
+
+    static CompressedBitsetContainer fromWords(std::vector<uint64_t> w) {
+        w.resize(Words);
+        CompressedBitsetContainer res;
+        res.type = Bitmap;
+        res.card = cntOnes(&w[0], Words);
+        res.words = std::move(w);
+        res.optimize();
+        return res;
+    }
+
+    static CompressedBitsetContainer fromValues(std::vector<uint16_t> v) {
+        CompressedBitsetContainer res;
+        res.card = (int)v.size();
+        res.arr = std::move(v);
+        res.optimize();
+        return res;
+    }
+
+    static CompressedBitsetContainer fromRuns(std::vector<Segment> r) {
+        CompressedBitsetContainer res;
+        res.type = Run;
+        for (auto [lo, hi] : r) res.card += hi - lo + 1;
+        res.runs = std::move(r);
+        res.optimize();
+        return res;
+    }
+
+    // Intersection of sorted arrays, galloping if sizes differ a lot:
+    static std::vector<uint16_t> intersect(const std::vector<uint16_t> &a, const std::vector<uint16_t> &b) {
+        if (a.size() > b.size()) return intersect(b, a);
+        std::vector<uint16_t> res;
+        if (a.size() * 32 < b.size()) {
+            auto it = b.begin();
+            for (auto x : a) {
+                it = std::lower_bound(it, b.end(), x);
+                if (it == b.end()) break;
+                if (*it == x) res.push_back(x);
+            }
+        } else {
+            std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(res));
+        }
+        return res;
+    }
+
+    // Values of array container `a` which are present in `b`:
+    static std::vector<uint16_t> filter(const CompressedBitsetContainer &a, const CompressedBitsetContainer &b) {
+        if (b.type == Array) return intersect(a.arr, b.arr);
+        std::vector<uint16_t> res;
+        for (auto x : a.arr) if (b.test(x)) res.push_back(x);
+        return res;
+    }
+
+    template<typename Op>
+    static std::vector<uint64_t> bitmapOp(const CompressedBitsetContainer &a, const CompressedBitsetContainer &b, Op op) {
+        auto w = a.bitmap();
+        if (b.type == Bitmap) op(&w[0], &b.words[0], Words);
+        else op(&w[0], &b.bitmap()[0], Words);
+        return w;
+    }
+
+    static CompressedBitsetContainer opAND(const CompressedBitsetContainer &a, const CompressedBitsetContainer &b) {
+        if (a.type == Array) return fromValues(filter(a, b));
+        if (b.type == Array) return fromValues(filter(b, a));
+        if (a.type == Run && b.type == Run) {
+            std::vector<Segment> r;
+            for (int i = 0, j = 0; i < (int)a.runs.size() && j < (int)b.runs.size(); ) {
+                const auto lo = std::max(a.runs[i].first, b.runs[j].first);
+                const auto hi = std::min(a.runs[i].second, b.runs[j].second);
+                if (lo <= hi) r.emplace_back(lo, hi);
+                a.runs[i].second < b.runs[j].second ? i++ : j++;
+            }
+            return fromRuns(std::move(r));
+        }
+        return fromWords(bitmapOp(a, b, setBitAND));
+    }
+
+    static CompressedBitsetContainer opOR(const CompressedBitsetContainer &a, const CompressedBitsetContainer &b) {
+        if (a.type == Array && b.type == Array) {
+            std::vector<uint16_t> res;
+            std::set_union(a.arr.begin(), a.arr.end(), b.arr.begin(), b.arr.end(), std::back_inserter(res));
+            return fromValues(std::move(res));
+        }
+        if (a.type == Run && b.type == Run) {
+            std::vector<Segment> all, r;
+            std::merge(a.runs.begin(), a.runs.end(), b.runs.begin(), b.runs.end(), std::back_inserter(all));
+            for (auto [lo, hi] : all) {
+                if (r.empty() || r.back().second + 1 < lo) r.emplace_back(lo, hi);
+                else r.back().second = std::max(r.back().second, hi);
+            }
+            return fromRuns(std::move(r));
+        }
+        return fromWords(bitmapOp(a, b, setBitOR));
+    }
+
+    static CompressedBitsetContainer opXOR(const CompressedBitsetContainer &a, const CompressedBitsetContainer &b) {
+        if (a.type == Array && b.type == Array) {
+            std::vector<uint16_t> res;
+            std::set_symmetric_difference(a.arr.begin(), a.arr.end(), b.arr.begin(), b.arr.end(), std::back_inserter(res));
+            return fromValues(std::move(res));
+        }
+        return fromWords(bitmapOp(a, b, setBitXOR));
+    }
+
+    static int countAND(const CompressedBitsetContainer &a, const CompressedBitsetContainer &b) {
+        if (a.type == Array) return (int)filter(a, b).size();
+        if (b.type == Array) return (int)filter(b, a).size();
+        if (a.type == Bitmap && b.type == Bitmap) return cntAND(&a.words[0], &b.words[0], Words);
+        return cntAND(&a.bitmap()[0], &b.bitmap()[0], Words);
+    }
+
+    // Operations with `cnt` words of dense bitset, missing words are zero:
+    void andWords(const uint64_t *w, int cnt) {
+        if (type == Array) {
+            std::vector<uint16_t> res;
+            for (auto x : arr)
+                if (x / 64 < cnt && ((w[x/64] >> x % 64) & 1))
+                    res.push_back(x);
+            *this = fromValues(std::move(res));
+        } else {
+            auto v = bitmap();
+            if (cnt) setBitAND(&v[0], w, cnt);
+            std::fill(v.begin() + cnt, v.end(), 0);
+            *this = fromWords(std::move(v));
+        }
+    }
+
+    int countWords(const uint64_t *w, int cnt) const {
+        if (type == Array) {
+            int res = 0;
+            for (auto x : arr)
+                res += (x / 64 < cnt && ((w[x/64] >> x % 64) & 1));
+            return res;
+        }
+        if (cnt == 0) return 0;
+        return type == Bitmap ? cntAND(&words[0], w, cnt) : cntAND(&bitmap()[0], w, cnt);
+    }
+};
+
+/**
+ *  CompressedBitset - roaring-style bitset on [0, n) with the interface of Bitset:
+ *  universe is split into chunks of 2^16 bits, only non-empty chunks are stored
+ *  (sorted by key = i >> 16) as CompressedBitsetContainer. Memory is proportional
+ *  to number of set bits (sparse data) or to number of segments of ones (data with
+ *  long runs), and never exceeds n/8 bytes by much. Bulk operations are done per
+ *  pair of containers: merge/galloping for arrays, Bitset kernels for bitmaps.
+ *  Difference from Bitset: for |= and ^= universe of result is the larger one.
+ */
+struct CompressedBitset {
+
+    using Container = CompressedBitsetContainer;
+
+    static constexpr int Bits = Container::Bits, Words = Container::Words;
+
+    struct Reference {
+        CompressedBitset &b; int i;
+        Reference(CompressedBitset &b_, int i_) : b(b_), i(i_) { }
+        operator bool() const { return b.test(i); }
+        Reference &operator=(bool x) { return (x ? b.set(i) : b.reset(i), *this); }
+    };
+
+    int n;
+
+    std::vector<int> keys;
+
+    std::vector<Container> chunks;
+
+    CompressedBitset(int n_ = 0) : n(n_) { }
+
+    CompressedBitset(const std::string &s)
+        : CompressedBitset((int)s.size())
+    {
+        for (int i = 0; i < (int)s.size(); i++)
+            if (s[i] == '1')
+                set(i);
+    }
+
+    // Conversion from dense bitset, each chunk gets the smallest representation:
+    CompressedBitset(const Bitset &b) : n(b.n) {
+        const int sz = (int)b.data.size();
+        for (int g = 0; g < sz; g += Words) {
+            const int cnt = std::min(Words, sz - g);
+            if (allZero(&b.data[g], cnt)) continue;
+            keys.push_back(g / Words);
+            chunks.push_back(Container::fromWords(std::vector<uint64_t>(&b.data[g], &b.data[g] + cnt)));
+        }
+    }
+
+    Bitset toBitset() const {
+        Bitset res(n);
+        const int sz = (int)res.data.size();
+        for (int k = 0; k < (int)keys.size(); k++) {
+            const int g = keys[k] * Words;
+            if (chunks[k].type == Container::Bitmap) {
+                std::copy(chunks[k].words.begin(), chunks[k].words.begin() + std::min(Words, sz - g), &res.data[g]);
+            } else {
+                chunks[k].forEach([&](int x){ res.set(g * 64 + x); });
+            }
+        }
+        return res;
+    }
+
+    // Position of chunk with given key or position where it must be inserted:
+    int findChunk(int key) const {
+        return int(std::lower_bound(keys.begin(), keys.end(), key) - keys.begin());
+    }
+
+    void set(int i) {
+        assert(0 <= i && i < n);
+        const int key = i / Bits, k = findChunk(key);
+        if (k == (int)keys.size() || keys[k] != key) {
+            keys.insert(keys.begin() + k, key);
+            chunks.insert(chunks.begin() + k, Container());
+        }
+        chunks[k].set(i % Bits);
+    }
+
+    void reset(int i) {
+        const int key = i / Bits, k = findChunk(key);
+        if (k < (int)keys.size() && keys[k] == key && chunks[k].reset(i % Bits) && chunks[k].card == 0) {
+            keys.erase(keys.begin() + k);
+            chunks.erase(chunks.begin() + k);
+        }
+    }
+
+    void flip(int i) { test(i) ? reset(i) : set(i); }
+
+    bool test(int i) const {
+        const int key = i / Bits, k = findChunk(key);
+        return k < (int)keys.size() && keys[k] == key && chunks[k].test(i % Bits);
+    }
+
+    Reference operator[](int i) { return Reference(*this, i); }
+
+    void reset() { keys.clear(); chunks.clear(); }
+
+    bool isAny() const { return !keys.empty(); }
+
+    bool isNone() const { return !isAny(); }
+
+    bool isAll() const { return count() == n; }
+
+    int count() const {
+        int res = 0;
+        for (const auto &c : chunks) res += c.card;
+        return res;
+    }
+
+    // Convert all chunks to the smallest representation (after many point updates):
+    void optimize() { for (auto &c : chunks) c.optimize(); }
+
+    size_t memoryUsage() const {
+        size_t res = keys.capacity() * sizeof(int) + (chunks.capacity() - chunks.size()) * sizeof(Container);
+        for (const auto &c : chunks) res += c.memoryUsage();
+        return res;
+    }
+
+    // First set bit in chunks with index >= k:
+    int firstFromChunk(int k) const {
+        return k < (int)keys.size() ? keys[k] * Bits + chunks[k].lowerBound(0) : n;
+    }
+
+    int _Find_first() const { return firstFromChunk(0); }
+
+    int _Find_next(int i) const {
+        if (i+1 >= n)
+            return n;
+        const int key = (i+1) / Bits, k = findChunk(key);
+        if (k < (int)keys.size() && keys[k] == key)
+            if (int x = chunks[k].lowerBound((i+1) % Bits); x < Bits)
+                return key * Bits + x;
+        return firstFromChunk(k + (k < (int)keys.size() && keys[k] == key));
+    }
+
+    std::string to_string() const {
+        std::string res(n, '0');
+        for (int i = _Find_first(); i < n; i = _Find_next(i))
+            res[i] = '1';
+        std::reverse(res.begin(), res.end());
+        return res;
+    }
+
+    friend std::ostream &operator<<(std::ostream &os, const CompressedBitset &b) {
+        return os << b.to_string();
+    }
+
+    friend std::istream &operator>>(std::istream &is, CompressedBitset &b) {
+        std::string s; is >> s; b = CompressedBitset(s);
+        return is;
+    }
+
+    CompressedBitset &operator&=(const CompressedBitset &other) {
+        std::vector<int> resKeys;
+        std::vector<Container> resChunks;
+        for (int i = 0, j = 0; i < (int)keys.size() && j < (int)other.keys.size(); ) {
+            if (keys[i] < other.keys[j]) i++;
+            else if (keys[i] > other.keys[j]) j++;
+            else {
+                auto c = Container::opAND(chunks[i], other.chunks[j]);
+                if (c.card > 0) {
+                    resKeys.push_back(keys[i]);
+                    resChunks.push_back(std::move(c));
+                }
+                i++, j++;
+            }
+        }
+        keys.swap(resKeys);
+        chunks.swap(resChunks);
+        n = std::min(n, other.n);
+        return *this;
+    }
+
+    template<typename Op>
+    CompressedBitset &mergeWith(const CompressedBitset &other, Op op) {
+        std::vector<int> resKeys;
+        std::vector<Container> resChunks;
+        int i = 0, j = 0;
+        while (i < (int)keys.size() || j < (int)other.keys.size()) {
+            if (j == (int)other.keys.size() || (i < (int)keys.size() && keys[i] < other.keys[j])) {
+                resKeys.push_back(keys[i]);
+                resChunks.push_back(std::move(chunks[i++]));
+            } else if (i == (int)keys.size() || keys[i] > other.keys[j]) {
+                resKeys.push_back(other.keys[j]);
+                resChunks.push_back(other.chunks[j++]);
+            } else {
+                auto c = op(chunks[i], other.chunks[j]);
+                if (c.card > 0) {
+                    resKeys.push_back(keys[i]);
+                    resChunks.push_back(std::move(c));
+                }
+                i++, j++;
+            }
+        }
+        keys.swap(resKeys);
+        chunks.swap(resChunks);
+        n = std::max(n, other.n);
+        return *this;
+    }
+
+    CompressedBitset &operator|=(const CompressedBitset &other) { return mergeWith(other, Container::opOR); }
+
+    CompressedBitset &operator^=(const CompressedBitset &other) { return mergeWith(other, Container::opXOR); }
+
+    int countAND(const CompressedBitset &other) const {
+        int res = 0;
+        for (int i = 0, j = 0; i < (int)keys.size() && j < (int)other.keys.size(); ) {
+            if (keys[i] < other.keys[j]) i++;
+            else if (keys[i] > other.keys[j]) j++;
+            else res += Container::countAND(chunks[i++], other.chunks[j++]);
+        }
+        return res;
+    }
+
+    // Interoperation with dense Bitset:
+    CompressedBitset &operator&=(const Bitset &other) {
+        const int sz = (int)other.data.size();
+        int cnt = 0;
+        for (int k = 0; k < (int)keys.size(); k++) {
+            const int g = keys[k] * Words;
+            if (g >= sz) break;
+            chunks[k].andWords(&other.data[g], std::min(Words, sz - g));
+            if (chunks[k].card > 0) {
+                if (cnt != k) {
+                    keys[cnt] = keys[k];
+                    chunks[cnt] = std::move(chunks[k]);
+                }
+                cnt++;
+            }
+        }
+        keys.resize(cnt);
+        chunks.resize(cnt);
+        n = std::min(n, other.n);
+        return *this;
+    }
+
+    int countAND(const Bitset &other) const {
+        const int sz = (int)other.data.size();
+        int res = 0;
+        for (int k = 0; k < (int)keys.size(); k++) {
+            const int g = keys[k] * Words;
+            if (g >= sz) break;
+            res += chunks[k].countWords(&other.data[g], std::min(Words, sz - g));
+        }
+        return res;
+    }
+
+    friend CompressedBitset operator&(CompressedBitset a, const CompressedBitset &b) { return a &= b; }
+    friend CompressedBitset operator|(CompressedBitset a, const CompressedBitset &b) { return a |= b; }
+    friend CompressedBitset operator^(CompressedBitset a, const CompressedBitset &b) { return a ^= b; }
+};
+#endif // __COMPRESSEDBITSET_HPP__
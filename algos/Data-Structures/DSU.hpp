@@ -1,5 +1,7 @@
 #ifndef __DSU_HPP__
 #define __DSU_HPP__
+#include <atomic>
+#include <memory>
 namespace algos
 {
 namespace dsu
@@ -12,7 +14,15 @@ namespace dsu
                 par[i] = i;
         }
         int getPar(int u) {
-            return par[u] == u ? u : par[u] = getPar(par[u]);
+            // iterative path compression: no recursion on long chains
+            int root = u;
+            while (par[root] != root) root = par[root];
+            while (par[u] != root) {
+                const int next = par[u];
+                par[u] = root;
+                u = next;
+            }
+            return root;
         }
         void connect(int u, int v) {
             u = getPar(u);
@@ -26,6 +36,227 @@ namespace dsu
             return getPar(u) == getPar(v);
         }
     }; // class DSU
+    
+    // DSU with undo: union by size without path compression, so each `connect`
+    // changes O(1) cells and could be reverted. getPar works in O(log n)
+    struct RollbackDSU {
+        vi par, sz; vpii history; int components;
+        RollbackDSU(int n = 0) : par(n), sz(n,1), components(n)
+        {
+            for (int i = 0; i < n; i++)
+                par[i] = i;
+        }
+        int getPar(int u) const {
+            while (par[u] != u) u = par[u];
+            return u;
+        }
+        bool connect(int u, int v) {
+            u = getPar(u);
+            v = getPar(v);
+            if (u == v) return false;
+            if (sz[u] < sz[v]) std::swap(u,v);
+            history.emplace_back(u, v);
+            sz[u] += sz[v];
+            par[v] = u;
+            components--;
+            return true;
+        }
+        bool isConnected(int u, int v) const {
+            return getPar(u) == getPar(v);
+        }
+        // number of successful `connect` calls, state could be restored by rollback(snapshot)
+        int snapshot() const { return isz(history); }
+        void rollback(int k) {
+            while (isz(history) > k) {
+                auto [u, v] = history.back();
+                history.pop_back();
+                sz[u] -= sz[v];
+                par[v] = v;
+                components++;
+            }
+        }
+    }; // class RollbackDSU
+    
+    // Offline dynamic connectivity: segment tree over time of queries, each edge is added
+    // to O(log q) nodes covering its lifetime, DFS over tree connects edges in RollbackDSU
+    // and rollbacks them on exit. Total: O((n + q) log q log n)
+    struct DynamicConnectivity {
+        enum QueryType { Connected, Components };
+        int n;
+        std::map<pii, vi> opened; // edge -> list of its start times (multiedges are allowed)
+        std::vector<std::tuple<int,int,int,int>> edges; // {from time, to time, u, v}
+        std::vector<std::tuple<QueryType,int,int>> queries;
+        DynamicConnectivity(int n_ = 0) : n(n_) { }
+        static pii key(int u, int v) { return u < v ? pii(u, v) : pii(v, u); }
+        void add_edge(int u, int v) { opened[key(u,v)] << isz(queries); }
+        void remove_edge(int u, int v) {
+            auto it = opened.find(key(u,v));
+            assert(it != opened.end() && !it->second.empty() && "Edge must exist!");
+            edges.emplace_back(it->second.back(), isz(queries), u, v);
+            it->second.pop_back();
+            if (it->second.empty()) opened.erase(it);
+        }
+        // Returns index of query in result of solve():
+        int query_connected(int u, int v) { return queries.emplace_back(Connected, u, v), isz(queries)-1; }
+        int query_components() { return queries.emplace_back(Components, 0, 0), isz(queries)-1; }
+        
+        vvpii tree;
+        void addToTree(int v, int tl, int tr, int ql, int qr, const pii &edge) {
+            if (qr < tl || tr < ql) return;
+            if (ql <= tl && tr <= qr) { tree[v] << edge; return; }
+            const int tm = (tl + tr) / 2;
+            addToTree(2*v+1, tl, tm, ql, qr, edge);
+            addToTree(2*v+2, tm+1, tr, ql, qr, edge);
+        }
+        void dfs(int v, int tl, int tr, RollbackDSU &dsu, vi &answ) const {
+            const int snap = dsu.snapshot();
+            for (auto [a, b] : tree[v])
+                dsu.connect(a, b);
+            if (tl == tr) {
+                auto [type, a, b] = queries[tl];
+                answ[tl] = (type == Connected ? dsu.isConnected(a, b) : dsu.components);
+            } else {
+                const int tm = (tl + tr) / 2;
+                dfs(2*v+1, tl, tm, dsu, answ);
+                dfs(2*v+2, tm+1, tr, dsu, answ);
+            }
+            dsu.rollback(snap);
+        }
+        // Answers for all queries: 0/1 for query_connected, number of components for query_components
+        vi solve() {
+            const int q = isz(queries);
+            if (q == 0) return {};
+            tree.assign(4 * q, {});
+            for (auto &[from, to, u, v] : edges)
+                if (from < to) addToTree(0, 0, q-1, from, to-1, pii(u, v));
+            for (auto &[edge, times] : opened)
+                for (int from : times)
+                    if (from < q) addToTree(0, 0, q-1, from, q-1, edge);
+            RollbackDSU dsu(n);
+            vi answ(q);
+            dfs(0, 0, q-1, dsu, answ);
+            return answ;
+        }
+    }; // class DynamicConnectivity
+    
+    // Abelian groups for WeightedDSU: `neutral`, `merge` and `inverse` of Type
+    template<typename T>
+    struct GroupSum {
+        using Type = T;
+        static T neutral() { return T(0); }
+        static T merge(const T& a, const T& b) { return a + b; }
+        static T inverse(const T& a) { return -a; }
+    };
+    
+    template<typename T>
+    struct GroupXor { // parity for bipartiteness checks: GroupXor<int> with 0/1 potentials
+        using Type = T;
+        static T neutral() { return T(0); }
+        static T merge(const T& a, const T& b) { return a ^ b; }
+        static T inverse(const T& a) { return a; }
+    };
+    
+    // DSU with potentials: pot[u] = w(u) - w(par[u]) in abelian Group, so the difference
+    // between any two vertices of one set is known. Arrays are stored separately (SoA)
+    template<typename Group = GroupSum<ll>>
+    struct WeightedDSU {
+        using T = typename Group::Type;
+        vi par, sz; std::vector<T> pot;
+        WeightedDSU(int n) : par(n), sz(n,1), pot(n, Group::neutral())
+        {
+            for (int i = 0; i < n; i++)
+                par[i] = i;
+        }
+        // {root of `u`, w(u) - w(root)} in one path walk, after call pot[u] = w(u) - w(root)
+        std::pair<int, T> find(int u) {
+            int root = u;
+            T total = Group::neutral();
+            for (; par[root] != root; root = par[root])
+                total = Group::merge(total, pot[root]);
+            const std::pair<int, T> res(root, total);
+            // iterative path compression, `total` = w(u) - w(root) for current `u`:
+            while (par[u] != root && u != root) {
+                const int next = par[u];
+                const T nextTotal = Group::merge(total, Group::inverse(pot[u]));
+                pot[u] = total;
+                par[u] = root;
+                u = next;
+                total = nextTotal;
+            }
+            return res;
+        }
+        // root of `u`
+        int getPar(int u) { return find(u).first; }
+        // w(u) - w(root)
+        T potential(int u) { return find(u).second; }
+        // add constraint w(u) - w(v) = w, returns false if it contradicts previous ones
+        bool connect(int u, int v, T w) {
+            auto [ru, pu] = find(u);
+            auto [rv, pv] = find(v);
+            if (ru == rv) return Group::merge(pu, Group::inverse(pv)) == w;
+            // w(ru) - w(rv) = w - pu + pv
+            T d = Group::merge(Group::merge(w, Group::inverse(pu)), pv);
+            if (sz[ru] > sz[rv]) std::swap(ru, rv), d = Group::inverse(d);
+            sz[rv] += sz[ru];
+            par[ru] = rv;
+            pot[ru] = d;
+            return true;
+        }
+        bool isConnected(int u, int v) {
+            return getPar(u) == getPar(v);
+        }
+        // w(u) - w(v), vertices must be connected
+        T diff(int u, int v) {
+            assert(isConnected(u, v));
+            return Group::merge(potential(u), Group::inverse(potential(v)));
+        }
+    }; // class WeightedDSU
+    
+    // Lock-free DSU: `connect`, `getPar` and `isConnected` could be called from many threads.
+    // Roots are linked by CAS in order of random priorities, getPar does path halving by CAS.
+    struct ConcurrentDSU {
+        int n;
+        std::unique_ptr<std::atomic<int>[]> par;
+        vi prio;
+        ConcurrentDSU(int n_, uint64_t seed = 666) : n(n_), par(new std::atomic<int>[n_]), prio(n_)
+        {
+            for (int i = 0; i < n; i++) {
+                par[i].store(i, std::memory_order_relaxed);
+                prio[i] = i;
+            }
+            std::shuffle(prio.begin(), prio.end(), std::mt19937_64(seed));
+        }
+        int getPar(int u) const {
+            while (true) {
+                int p = par[u].load(std::memory_order_acquire);
+                if (p == u) return u;
+                const int gp = par[p].load(std::memory_order_acquire);
+                if (p != gp) // path halving, it is ok if other thread changed par[u] first
+                    par[u].compare_exchange_weak(p, gp, std::memory_order_release, std::memory_order_relaxed);
+                u = gp;
+            }
+        }
+        bool connect(int u, int v) {
+            while (true) {
+                u = getPar(u);
+                v = getPar(v);
+                if (u == v) return false;
+                if (prio[u] > prio[v]) std::swap(u, v);
+                int expected = u; // link root `u` with smaller priority under `v`
+                if (par[u].compare_exchange_strong(expected, v, std::memory_order_acq_rel))
+                    return true;
+            }
+        }
+        bool isConnected(int u, int v) const {
+            while (true) {
+                u = getPar(u);
+                v = getPar(v);
+                if (u == v) return true;
+                // `u` is still a root, so `u` and `v` were in different sets at this moment
+                if (par[u].load(std::memory_order_acquire) == u) return false;
+            }
+        }
+    }; // class ConcurrentDSU
 } // namespace dsu
 } // namespace algos
 #endif // __DSU_HPP__
\ No newline at end of file
@@ -24,13 +24,17 @@ using namespace SegmentTreeLazyTraits;
     template<typename Value, typename Extra> using TraitsSumMul = LazySumMul<Value, Extra>;
         
     /*******************************************************************************
-     *  SegmentTree, see description above
+     *  SegmentTree, see description above.
+     *  Nodes are stored in contiguous pool `nodes` with 32-bit indices, children of
+     *  one node are allocated together. Only updates allocate nodes: read queries
+     *  treat missing children as implicit neutral nodes and compose extras of
+     *  ancestors on the way down instead of pushing them.
      ******************************************************************************/
     template<typename Value = int64_t, typename Extra = int64_t, typename Traits = TraitsMinAdd<Value, Extra> >
     struct SegmentTree {
 		
         /*******************************************************************************
-         *  Node class
+         *  Node class, `leftChild == 0` means that node has no children
          ******************************************************************************/
         struct Node {
             Value value;
@@ -42,23 +46,7 @@ using namespace SegmentTreeLazyTraits;
             Node(Value value_ = Traits::valueNeutral(), Extra extra_ = Traits::extraNeutral())
                 : value(value_), extra(extra_) { }
             
-            Value getValue(ll l, ll r) const { return Traits::getValue(NodeWrapper<Node>(l, r, *this)); }
-			
-			Node *getLeftChild(SegmentTree *owner) {
-				if (!leftChild) {
-					leftChild = owner->newNode();
-					owner->newNode();
-				}
-				return &(owner->nodes[leftChild]);
-			}
-			
-			Node *getRightChild(SegmentTree *owner) {
-				if (!leftChild) {
-					leftChild = owner->newNode();
-					owner->newNode();
-				}
-				return &(owner->nodes[leftChild+1]);
-			}
+            Value getValue(ll l, ll r) const { return Traits::getValue(NodeWrapper<const Node&>(l, r, *this)); }
         };
         
         /*******************************************************************************
@@ -81,15 +69,34 @@ using namespace SegmentTreeLazyTraits;
         };        
         
 		/*******************************************************************************
-         *  SegmentTree public data: n - number of items, data - vector for nodes
+         *  SegmentTree public data: n - number of items, nodes - pool for nodes (root is 0)
          ******************************************************************************/
-        ll n; std::deque<Node> nodes{Node()};
+        ll n; std::vector<Node> nodes{Node()};
         
         SegmentTree(ll n_ = 0) { resize(n_); }
         
+        /*******************************************************************************
+         *  Pool management: reserve memory for `cnt` nodes, number of nodes and
+         *  number of bytes used by pool
+         ******************************************************************************/
+        void reserve(int cnt) { nodes.reserve(cnt); }
+        
+        int size() const { return (int)nodes.size(); }
+        
+        size_t memoryUsage() const { return nodes.capacity() * sizeof(Node); }
+        
 		int newNode() {
+            assert(nodes.size() < (size_t)std::numeric_limits<int>::max());
 			nodes.push_back(Node());
 			return int(nodes.size())-1;
+        }
+        
+        void createChildren(int v) {
+            if (!nodes[v].leftChild) {
+                const int child = newNode();
+                newNode();
+                nodes[v].leftChild = child;
+            }
 		}
 		
         /*******************************************************************************
@@ -100,92 +107,185 @@ using namespace SegmentTreeLazyTraits;
         /*******************************************************************************
          *  Lazy propagation from node to its children
          ******************************************************************************/
-        void push(Node *curr, ll l, ll r, ll m) {
-            assert(curr);
-			if (curr->extra != Traits::extraNeutral()) {
+        void push(int v, ll l, ll r, ll m) {
+            if (nodes[v].extra != Traits::extraNeutral()) {
+                createChildren(v);
+                const int lt = nodes[v].leftChild;
                 Traits::push(
-                    NodeWrapper<Node&>(l, m, *(curr->getLeftChild(this))), 
-                    NodeWrapper<const Node&>(l, r, *(curr))
+                    NodeWrapper<Node&>(l, m, nodes[lt]),
+                    NodeWrapper<const Node&>(l, r, nodes[v])
                 );
                 Traits::push(
-                    NodeWrapper<Node&>(m+1, r, *(curr->getRightChild(this))),
-                    NodeWrapper<const Node&>(l, r, *curr)
+                    NodeWrapper<Node&>(m+1, r, nodes[lt+1]),
+                    NodeWrapper<const Node&>(l, r, nodes[v])
                 );
-                curr->extra = Traits::extraNeutral();
+                nodes[v].extra = Traits::extraNeutral();
             }
         }
         
         /*******************************************************************************
          *  Update node using children values
          ******************************************************************************/
-        void pull(Node *curr, ll l, ll r, ll m) {
-            assert(curr);
-			assert(curr->extra == Traits::extraNeutral());
+        void pull(int v, ll l, ll r, ll m) {
+            assert(nodes[v].extra == Traits::extraNeutral());
+            createChildren(v);
+            const int lt = nodes[v].leftChild;
             Traits::pull(
-                NodeWrapper<Node&>(  l, r, *curr), 
-                NodeWrapper<const Node&>(  l, m, *(curr->getLeftChild(this))), 
-                NodeWrapper<const Node&>(m+1, r, *(curr->getRightChild(this)))
+                NodeWrapper<Node&>(  l, r, nodes[v]),
+                NodeWrapper<const Node&>(  l, m, nodes[lt]),
+                NodeWrapper<const Node&>(m+1, r, nodes[lt+1])
             );
         }
         
+        /*******************************************************************************
+         *  Read-only access: node `v` (0 - implicit neutral node) with composition of
+         *  extras of its ancestors `anc` applied, `anc` for children is result too
+         ******************************************************************************/
+        Node withAncestors(int v, const Node& anc, ll l, ll r) const {
+            Node ret = (v ? nodes[v] : Node());
+            if (anc.extra != Traits::extraNeutral()) {
+                Traits::push(NodeWrapper<Node&>(l, r, ret), NodeWrapper<const Node&>(l, r, anc));
+            }
+            return ret;
+        }
+        
+        int leftChild(const Node& node) const { return node.leftChild; }
+        
+        int rightChild(const Node& node) const { return node.leftChild ? node.leftChild + 1 : 0; }
+        
         /*******************************************************************************
          *  Get-query on range [ql, qr]
          ******************************************************************************/
-        Node get(ll ql, ll qr, Node *curr, const ll tl, const ll tr) {
+        Node get(ll ql, ll qr, const Node& curr, const ll tl, const ll tr) const {
             if (ql == tl && qr == tr) {
-                return *curr;
+                return Node(curr.getValue(tl, tr));
             } else {
                 ll tm = (tl + tr) / 2;
-                push(curr, tl, tr, tm);
-                Node ret;
                 if (qr <= tm) {
-                    ret = get(ql, qr, curr->getLeftChild(this),   tl, tm);
+                    return get(ql, qr, withAncestors(leftChild(curr), curr, tl, tm), tl, tm);
                 } else if (ql > tm) {
-                    ret = get(ql, qr, curr->getRightChild(this), tm+1, tr);
+                    return get(ql, qr, withAncestors(rightChild(curr), curr, tm+1, tr), tm+1, tr);
                 } else {
-                    const auto lt = get(  ql, tm, curr->getLeftChild(this),   tl, tm);
-                    const auto rt = get(tm+1, qr, curr->getRightChild(this), tm+1, tr);
+                    const auto lt = get(  ql, tm, withAncestors(leftChild(curr), curr, tl, tm),   tl, tm);
+                    const auto rt = get(tm+1, qr, withAncestors(rightChild(curr), curr, tm+1, tr), tm+1, tr);
+                Node ret;
                     Traits::pull(
                         NodeWrapper<Node&>(  ql, qr, ret), 
                         NodeWrapper<const Node&>(  ql, tm, lt), 
                         NodeWrapper<const Node&>(tm+1, qr, rt)
                     );
-                }
-                pull(curr, tl, tr, tm);
                 return ret;
             }
         }
+        }
         
-        Value get(const ll ql, const ll qr) {
-			return get(ql, qr, &nodes[0], 0, n-1).getValue(ql, qr);
+        Value get(const ll ql, const ll qr) const {
+            return get(ql, qr, nodes[0], 0, n-1).value;
 		}
         
         /*******************************************************************************
          *  Update query on range [ql, qr] by extra
          ******************************************************************************/
-        void update(const ll ql, const ll qr, const Extra& extra, Node *curr, const ll tl, const ll tr) {
+        void update(const ll ql, const ll qr, const Extra& extra, const int v, const ll tl, const ll tr) {
             if (ql == tl && tr == qr) {
                 Traits::push(
-                    NodeWrapper<Node&>(tl, tr, *curr),
+                    NodeWrapper<Node&>(tl, tr, nodes[v]),
                     NodeWrapper<Node>(ql, qr, Node(Traits::valueNeutral(), extra))
                 );
             } else {
                 ll tm = (tl + tr) / 2;
-                push(curr, tl, tr, tm);
+                push(v, tl, tr, tm);
+                createChildren(v);
+                const int lt = nodes[v].leftChild;
                 if (qr <= tm) {
-                    update(ql, qr, extra, curr->getLeftChild(this), tl, tm);
+                    update(ql, qr, extra, lt, tl, tm);
                 } else if (ql > tm) {
-                    update(ql, qr, extra, curr->getRightChild(this),tm+1,tr);
+                    update(ql, qr, extra, lt+1, tm+1, tr);
                 } else {
-                    update(ql, tm, extra, curr->getLeftChild(this),   tl, tm);
-                    update(tm+1, qr, extra, curr->getRightChild(this), tm+1, tr);
+                    update(ql, tm, extra, lt,   tl, tm);
+                    update(tm+1, qr, extra, lt+1, tm+1, tr);
                 }
-                pull(curr, tl, tr, tm);
+                pull(v, tl, tr, tm);
             }
         }
 
         void update(const ll ql, const ll qr, const Extra& extra) {
-            update(ql, qr, extra, &nodes[0], 0, n-1);
+            update(ql, qr, extra, 0, 0, n-1);
+        }
+        
+        /*******************************************************************************
+         *  Merge accumulated node `acc` with node `curr` on [tl, tr]
+         ******************************************************************************/
+        Node mergeRight(const Node& acc, const ll ql, const Node& curr, const ll tl, const ll tr) const {
+            if (ql == tl) { return Node(curr.getValue(tl, tr)); }
+            Node ret;
+            Traits::pull(
+                NodeWrapper<Node&>(ql, tr, ret),
+                NodeWrapper<const Node&>(ql, tl-1, acc),
+                NodeWrapper<const Node&>(tl, tr, curr)
+            );
+            return ret;
+        }
+        
+        Node mergeLeft(const Node& curr, const ll tl, const ll tr, const Node& acc, const ll qr) const {
+            if (qr == tr) { return Node(curr.getValue(tl, tr)); }
+            Node ret;
+            Traits::pull(
+                NodeWrapper<Node&>(tl, qr, ret),
+                NodeWrapper<const Node&>(tl, tr, curr),
+                NodeWrapper<const Node&>(tr+1, qr, acc)
+            );
+            return ret;
+        }
+        
+        /*******************************************************************************
+         *  Descent queries, `pred(valueNeutral)` must be true and `pred` must be monotone:
+         *      max_right(l, pred) - first r >= l such that pred(get(l, r)) is false, or n;
+         *      min_left(r, pred)  - first l <= r+1 such that pred(get(l, r)) is true.
+         *  Return -1 from recursive versions if the answer is not in [tl, tr]
+         ******************************************************************************/
+        template<typename Pred>
+        ll max_right(const ll ql, Pred& pred, Node& acc, const Node& curr, const ll tl, const ll tr) const {
+            if (tr < ql) { return -1; }
+            if (ql <= tl) {
+                Node next = mergeRight(acc, ql, curr, tl, tr);
+                if (pred(next.value)) { acc = next; return -1; }
+                if (tl == tr) { return tl; }
+            }
+            const ll tm = (tl + tr) / 2;
+            ll ret = max_right(ql, pred, acc, withAncestors(leftChild(curr), curr, tl, tm), tl, tm);
+            if (ret == -1) { ret = max_right(ql, pred, acc, withAncestors(rightChild(curr), curr, tm+1, tr), tm+1, tr); }
+            return ret;
+        }
+        
+        template<typename Pred>
+        ll max_right(const ll ql, Pred pred) const {
+            if (ql >= n) { return n; }
+            Node acc;
+            const ll ret = max_right(ql, pred, acc, nodes[0], 0, n-1);
+            return ret == -1 ? n : ret;
+        }
+        
+        template<typename Pred>
+        ll min_left(const ll qr, Pred& pred, Node& acc, const Node& curr, const ll tl, const ll tr) const {
+            if (tl > qr) { return -1; }
+            if (tr <= qr) {
+                Node next = mergeLeft(curr, tl, tr, acc, qr);
+                if (pred(next.value)) { acc = next; return -1; }
+                if (tl == tr) { return tl + 1; }
+            }
+            const ll tm = (tl + tr) / 2;
+            ll ret = min_left(qr, pred, acc, withAncestors(rightChild(curr), curr, tm+1, tr), tm+1, tr);
+            if (ret == -1) { ret = min_left(qr, pred, acc, withAncestors(leftChild(curr), curr, tl, tm), tl, tm); }
+            return ret;
+        }
+        
+        template<typename Pred>
+        ll min_left(const ll qr, Pred pred) const {
+            if (qr < 0) { return 0; }
+            Node acc;
+            const ll ret = min_left(qr, pred, acc, nodes[0], 0, n-1);
+            return ret == -1 ? 0 : ret;
         }
 
     };
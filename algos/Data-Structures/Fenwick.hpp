@@ -12,11 +12,13 @@ struct Fenwick {
     
     void build(int n) { data.assign(n, T{}); }
     
+    // O(n) build: each item passes its partial sum to the parent
     void build(const auto &a) {
         const int n = (int)std::size(a);
-        build(n);
+        data.assign(std::begin(a), std::end(a));
         for (int i = 0; i < n; i++)
-            inc(i, a[i]);
+            if (int p = (i | (i+1)); p < n)
+                data[p] += data[i];
     }
 
     // Sum on segment [0, r]:
@@ -99,4 +101,66 @@ struct FenwickSet : public Fenwick<T>
     // Works as same as npos in string
     int npos() const { return (int)this->data.size(); }
 };
+template<typename T>
+struct FenwickRange
+{
+    // Range-add / range-sum on two arrays: prefix sum [0, r] = b1.sum(r) * (r+1) - b2.sum(r)
+    Fenwick<T> b1, b2;
+    
+    FenwickRange(int n = 0) { build(n); }
+    
+    FenwickRange(const auto &a) { build(a); }
+    
+    void build(int n) { b1.build(n), b2.build(n); }
+    
+    // O(n) build from array of values
+    void build(const auto &a) {
+        const int n = (int)std::size(a);
+        std::vector<T> d1(n), d2(n);
+        for (int i = 0; i < n; i++) {
+            d1[i] = T(a[i]) - (i > 0 ? T(a[i-1]) : T{});
+            d2[i] = d1[i] * T(i);
+        }
+        b1.build(d1), b2.build(d2);
+    }
+    
+    int size() const { return (int)b1.data.size(); }
+    
+    // Add x to each value on segment [l, r]:
+    void add(int l, int r, T x) {
+        b1.inc(l, x), b2.inc(l, x * T(l));
+        if (r+1 < size())
+            b1.inc(r+1, -x), b2.inc(r+1, -x * T(r+1));
+    }
+    void inc(int p, T x) { add(p, p, x); }
+    
+    // Sum on segment [0, r]:
+    T sum(int r) const { return r < 0 ? T{} : b1.sum(r) * T(r+1) - b2.sum(r); }
+    T operator()(int r) const { return sum(r); }
+    
+    // Sum on segment [l, r]:
+    T sum(int l, int r) const { return sum(r) - sum(l-1); }
+    T operator()(int l, int r) const { return sum(l, r); }
+    
+    // Lower bound for sum `s` as in Fenwick: sum[0]+...+sum[p-1] < s >= sum[0]+...+sum[p]
+    template<typename cmp = std::less<T>>
+    int binary_lifting(T s) const {
+        const int n = size();
+        int pos = 0;
+        T acc1{}, acc2{};
+        for (int p = std::__lg(std::max(n, 1)); p >= 0; p--) {
+            int next = pos + (1 << p) - 1;
+            if (next < n) {
+                const T next1 = acc1 + b1.data[next], next2 = acc2 + b2.data[next];
+                if (cmp()(next1 * T(next+1) - next2, s)) {
+                    acc1 = next1, acc2 = next2;
+                    pos = next + 1;
+                }
+            }
+        }
+        return pos;
+    }
+    
+    int last_less_equal(T s) const { return binary_lifting<std::less_equal<T>>(s) - 1; }
+};
 #endif // __FENWICK_HPP__
\ No newline at end of file
@@ -0,0 +1,146 @@
+#ifndef __FENWICK2D_HPP__
+#define __FENWICK2D_HPP__
+#include "mapoff.hpp"
+
+/**
+ *  Fenwick2D<T> - two-dimensional Fenwick tree on n x m grid, 0-indexed.
+ *  Data is stored in one row-major vector, so inner loop walks over one row.
+ */
+template<typename T>
+struct Fenwick2D {
+
+    int n{}, m{};
+
+    std::vector<T> data;
+
+    Fenwick2D(int n_ = 0, int m_ = 0) { build(n_, m_); }
+
+    Fenwick2D(const auto &a) { build(a); }
+
+    void build(int n_, int m_) { n = n_, m = m_; data.assign((size_t)n * m, T{}); }
+
+    // O(n*m) build from 2D array: each cell passes its value to the parent cell
+    void build(const auto &a) {
+        build((int)std::size(a), std::size(a) ? (int)std::size(a[0]) : 0);
+        for (int x = 0; x < n; x++)
+            for (int y = 0; y < m; y++)
+                data[(size_t)x * m + y] = a[x][y];
+        for (int x = 0; x < n; x++) {
+            T *row = &data[(size_t)x * m];
+            for (int y = 0; y < m; y++)
+                if (int p = (y | (y+1)); p < m)
+                    row[p] += row[y];
+        }
+        for (int x = 0; x < n; x++)
+            if (int p = (x | (x+1)); p < n)
+                for (int y = 0; y < m; y++)
+                    data[(size_t)p * m + y] += data[(size_t)x * m + y];
+    }
+
+    // Sum on rectangle [0, x] x [0, y]:
+    T sum(int x, int y) const {
+        assert(x < n && y < m);
+        T result = 0;
+        for (; x >= 0; x = (x & (x+1)) - 1) {
+            const T *row = &data[(size_t)x * m];
+            for (int j = y; j >= 0; j = (j & (j+1)) - 1)
+                result += row[j];
+        }
+        return result;
+    }
+
+    // Increase value on position (x, y) by delta:
+    void inc(int x, int y, T delta) {
+        assert(x >= 0 && y >= 0);
+        for (; x < n; x = (x | (x+1))) {
+            T *row = &data[(size_t)x * m];
+            for (int j = y; j < m; j = (j | (j+1)))
+                row[j] += delta;
+        }
+    }
+
+    // Sum on rectangle [x1, x2] x [y1, y2]:
+    T sum(int x1, int y1, int x2, int y2) const {
+        return sum(x2, y2) - sum(x1-1, y2) - sum(x2, y1-1) + sum(x1-1, y1-1);
+    }
+    T operator()(int x, int y) const { return sum(x, y); }
+    T operator()(int x1, int y1, int x2, int y2) const { return sum(x1, y1, x2, y2); }
+};
+
+/**
+ *  FenwickOffline2D<T, Key> - two-dimensional Fenwick tree on points with arbitrary
+ *  coordinates, known offline. X-coordinates are compressed by MapOff, each node of
+ *  outer tree stores sorted y-coordinates of its points and inner Fenwick tree.
+ *  Memory and time per query: O(k log k) and O(log^2 k), where k - number of points.
+ *  Usage: add_point(x, y) for all points, build(), then inc/sum queries.
+ */
+template<typename T, typename Key = int>
+struct FenwickOffline2D {
+
+    MapOff<Key, int> xs;
+
+    std::vector<std::pair<Key, Key>> points;
+
+    std::vector<std::vector<Key>> ys;
+
+    std::vector<std::vector<T>> data;
+
+    void add_point(const Key &x, const Key &y) {
+        xs.add_key(x);
+        points.emplace_back(x, y);
+    }
+
+    void build() {
+        xs.build();
+        const int n = xs.size();
+        ys.assign(n, {});
+        for (const auto &[x, y] : points)
+            for (int i = xs.findIndex(x); i < n; i = (i | (i+1)))
+                ys[i].push_back(y);
+        data.assign(n, {});
+        for (int i = 0; i < n; i++) {
+            std::sort(ys[i].begin(), ys[i].end());
+            ys[i].erase(std::unique(ys[i].begin(), ys[i].end()), ys[i].end());
+            data[i].assign(ys[i].size(), T{});
+        }
+        points.clear();
+        points.shrink_to_fit();
+    }
+
+    // Increase value in point (x, y) by delta, point must be added before build:
+    void inc(const Key &x, const Key &y, T delta) {
+        const int n = xs.size();
+        for (int i = xs.findIndex(x); i < n; i = (i | (i+1))) {
+            const int sz = (int)ys[i].size();
+            int j = int(std::lower_bound(ys[i].begin(), ys[i].end(), y) - ys[i].begin());
+            for (; j < sz; j = (j | (j+1)))
+                data[i][j] += delta;
+        }
+    }
+
+    // Sum on points with px < x (or px <= x if inclX) and py < y (or py <= y if inclY):
+    T sum(const Key &x, bool inclX, const Key &y, bool inclY) const {
+        const auto &keys = xs.keys;
+        int i = int((inclX ? std::upper_bound(keys.begin(), keys.end(), x)
+                           : std::lower_bound(keys.begin(), keys.end(), x)) - keys.begin()) - 1;
+        T result = 0;
+        for (; i >= 0; i = (i & (i+1)) - 1) {
+            const auto &col = ys[i];
+            int j = int((inclY ? std::upper_bound(col.begin(), col.end(), y)
+                               : std::lower_bound(col.begin(), col.end(), y)) - col.begin()) - 1;
+            for (; j >= 0; j = (j & (j+1)) - 1)
+                result += data[i][j];
+        }
+        return result;
+    }
+
+    // Sum on points with px <= x and py <= y:
+    T sum(const Key &x, const Key &y) const { return sum(x, true, y, true); }
+
+    // Sum on points in rectangle [x1, x2] x [y1, y2]:
+    T sum(const Key &x1, const Key &y1, const Key &x2, const Key &y2) const {
+        return sum(x2, true, y2, true) - sum(x1, false, y2, true)
+             - sum(x2, true, y1, false) + sum(x1, false, y1, false);
+    }
+};
+#endif // __FENWICK2D_HPP__
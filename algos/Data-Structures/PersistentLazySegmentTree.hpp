@@ -0,0 +1,259 @@
+#ifndef __PERSISTENTLAZYSEGMENTTREE_HPP__
+#define __PERSISTENTLAZYSEGMENTTREE_HPP__
+namespace algos {
+namespace PersistentLazySegmentTree {
+using namespace SegmentTreeLazyTraits;
+    /*******************************************************************************
+     *  SegmentTree<Value, Extra, Traits> - persistent segment tree with lazy propagation,
+     *  0-indexed, on the same Traits as SegmentTreeLazy and DynamicLazySegmentTree.
+     *  Each update copies nodes on its path (and children touched by push), so it
+     *  creates a new version in O(log n) fresh nodes and never changes old versions.
+     *  Nodes are stored in pool `nodes`, node 0 is an implicit neutral node, which is
+     *  never modified. Read queries do not allocate: they compose extras of ancestors
+     *  on the way down instead of pushing them.
+     *  Versions: `roots[ver]` - root of version `ver`, `cur` - current version,
+     *  switchTo(ver) selects version in O(1), update creates a new version from the
+     *  current one and makes it current.
+     ******************************************************************************/
+
+    /*******************************************************************************
+     *  Available traits, implemented in header file SegmentTreeLazyTraits.hpp
+     ******************************************************************************/
+    template<typename Value, typename Extra> using TraitsMinAdd = LazyMinAdd<Value, Extra>;
+    template<typename Value, typename Extra> using TraitsMaxAdd = LazyMaxAdd<Value, Extra>;
+    template<typename Value, typename Extra> using TraitsSumSet = LazySumSet<Value, Extra>;
+    template<typename Value, typename Extra> using TraitsSumMul = LazySumMul<Value, Extra>;
+
+    /*******************************************************************************
+     *  SegmentTree, see description above
+     ******************************************************************************/
+    template<typename Value = int64_t, typename Extra = int64_t, typename Traits = TraitsMinAdd<Value, Extra> >
+    struct SegmentTree {
+
+        /*******************************************************************************
+         *  Node class, child 0 is an implicit neutral node
+         ******************************************************************************/
+        struct Node {
+            Value value;
+
+            Extra extra;
+
+            int lt{}, rt{};
+
+            Node(Value value_ = Traits::valueNeutral(), Extra extra_ = Traits::extraNeutral())
+                : value(value_), extra(extra_) { }
+
+            Value getValue(ll l, ll r) const { return Traits::getValue(NodeWrapper<const Node&>(l, r, *this)); }
+        };
+
+        /*******************************************************************************
+         *  NodeWrapper class
+         ******************************************************************************/
+        template<typename NodeType>
+        struct NodeWrapper {
+            ll l, r;
+            NodeType node;
+            NodeWrapper(ll l_, ll r_, NodeType node_)
+                : l(l_), r(r_), node(node_) { }
+            ll  left() const { return l; }
+            ll right() const { return r; }
+            ll   mid() const { return (l+r)/2; }
+            ll   len() const { return r - l + 1; }
+            Value& value() { return node.value; }
+            Extra& extra() { return node.extra; }
+            const Value& value() const { return node.value; }
+            const Extra& extra() const { return node.extra; }
+        };
+
+        /*******************************************************************************
+         *  SegmentTree public data: n - number of items, nodes - pool for nodes,
+         *  roots - root of each version, cur - current version
+         ******************************************************************************/
+        ll n; std::vector<Node> nodes{Node()}; std::vector<int> roots{0}; int cur{};
+
+        SegmentTree(ll n_ = 0) { resize(n_); }
+
+        /*******************************************************************************
+         *  Pool management: reserve memory for `cnt` nodes, number of nodes and
+         *  number of bytes used by pool
+         ******************************************************************************/
+        void reserve(int cnt) { nodes.reserve(cnt); }
+
+        int size() const { return (int)nodes.size(); }
+
+        size_t memoryUsage() const { return nodes.capacity() * sizeof(Node) + roots.capacity() * sizeof(int); }
+
+        int copyNode(int v) {
+            assert(nodes.size() < (size_t)std::numeric_limits<int>::max());
+            nodes.push_back(nodes[v]);
+            return int(nodes.size())-1;
+        }
+
+        /*******************************************************************************
+         *  Versions: number of versions, current version and O(1) switching
+         ******************************************************************************/
+        int versions() const { return (int)roots.size(); }
+
+        int version() const { return cur; }
+
+        void switchTo(int ver) { assert(0 <= ver && ver < versions()); cur = ver; }
+
+        /*******************************************************************************
+         *  Resize segment tree to needed size, drops all versions
+         ******************************************************************************/
+        void resize(ll n_) {
+            n = n_;
+            nodes.assign(1, Node());
+            roots.assign(1, 0);
+            cur = 0;
+        }
+
+        /*******************************************************************************
+         *  Lazy propagation from node to copies of its children
+         ******************************************************************************/
+        void push(int v, ll l, ll r, ll m) {
+            if (nodes[v].extra != Traits::extraNeutral()) {
+                const int lt = copyNode(nodes[v].lt);
+                const int rt = copyNode(nodes[v].rt);
+                Traits::push(
+                    NodeWrapper<Node&>(l, m, nodes[lt]),
+                    NodeWrapper<const Node&>(l, r, nodes[v])
+                );
+                Traits::push(
+                    NodeWrapper<Node&>(m+1, r, nodes[rt]),
+                    NodeWrapper<const Node&>(l, r, nodes[v])
+                );
+                nodes[v].lt = lt;
+                nodes[v].rt = rt;
+                nodes[v].extra = Traits::extraNeutral();
+            }
+        }
+
+        /*******************************************************************************
+         *  Update node using children values
+         ******************************************************************************/
+        void pull(int v, ll l, ll r, ll m) {
+            assert(nodes[v].extra == Traits::extraNeutral());
+            Traits::pull(
+                NodeWrapper<Node&>(  l, r, nodes[v]),
+                NodeWrapper<const Node&>(  l, m, nodes[nodes[v].lt]),
+                NodeWrapper<const Node&>(m+1, r, nodes[nodes[v].rt])
+            );
+        }
+
+        /*******************************************************************************
+         *  Build version 0 from array with given values
+         ******************************************************************************/
+        template<typename T>
+        int build(const std::vector<T>& arr, const ll tl, const ll tr) {
+            const int v = copyNode(0);
+            if (tl == tr) {
+                nodes[v].value = arr[tl];
+            } else {
+                const ll tm = (tl + tr) / 2;
+                const int lt = build(arr, tl, tm);
+                const int rt = build(arr, tm+1, tr);
+                nodes[v].lt = lt;
+                nodes[v].rt = rt;
+                pull(v, tl, tr, tm);
+            }
+            return v;
+        }
+
+        template<typename T>
+        void build(const std::vector<T>& arr) {
+            resize((ll)arr.size());
+            nodes.reserve(2 * arr.size());
+            roots[0] = build(arr, 0, n-1);
+        }
+
+        /*******************************************************************************
+         *  Read-only access: node `v` with composition of extras of its ancestors
+         *  `anc` applied, result is `anc` for children of `v`
+         ******************************************************************************/
+        Node withAncestors(int v, const Node& anc, ll l, ll r) const {
+            Node ret = nodes[v];
+            if (anc.extra != Traits::extraNeutral()) {
+                Traits::push(NodeWrapper<Node&>(l, r, ret), NodeWrapper<const Node&>(l, r, anc));
+            }
+            return ret;
+        }
+
+        /*******************************************************************************
+         *  Get-query on range [ql, qr] in version `ver` (current version by default)
+         ******************************************************************************/
+        Node get(ll ql, ll qr, const Node& curr, const ll tl, const ll tr) const {
+            if (ql == tl && qr == tr) {
+                return Node(curr.getValue(tl, tr));
+            } else {
+                ll tm = (tl + tr) / 2;
+                if (qr <= tm) {
+                    return get(ql, qr, withAncestors(curr.lt, curr, tl, tm), tl, tm);
+                } else if (ql > tm) {
+                    return get(ql, qr, withAncestors(curr.rt, curr, tm+1, tr), tm+1, tr);
+                } else {
+                    const auto lt = get(  ql, tm, withAncestors(curr.lt, curr, tl, tm),   tl, tm);
+                    const auto rt = get(tm+1, qr, withAncestors(curr.rt, curr, tm+1, tr), tm+1, tr);
+                    Node ret;
+                    Traits::pull(
+                        NodeWrapper<Node&>(  ql, qr, ret),
+                        NodeWrapper<const Node&>(  ql, tm, lt),
+                        NodeWrapper<const Node&>(tm+1, qr, rt)
+                    );
+                    return ret;
+                }
+            }
+        }
+
+        Value get(const ll ql, const ll qr, const int ver) const {
+            return get(ql, qr, nodes[roots[ver]], 0, n-1).value;
+        }
+
+        Value get(const ll ql, const ll qr) const { return get(ql, qr, cur); }
+
+        /*******************************************************************************
+         *  Update query on range [ql, qr] by extra, returns copy of node `v`. Nodes with
+         *  index >= `fresh` were created by this update (e.g. children copied by push),
+         *  they belong only to the new version and are modified in place
+         ******************************************************************************/
+        int update(const ll ql, const ll qr, const Extra& extra, const int v, const ll tl, const ll tr, const int fresh) {
+            const int nv = v >= fresh ? v : copyNode(v);
+            if (ql == tl && tr == qr) {
+                Traits::push(
+                    NodeWrapper<Node&>(tl, tr, nodes[nv]),
+                    NodeWrapper<Node>(ql, qr, Node(Traits::valueNeutral(), extra))
+                );
+            } else {
+                ll tm = (tl + tr) / 2;
+                push(nv, tl, tr, tm);
+                if (qr <= tm) {
+                    const int lt = update(ql, qr, extra, nodes[nv].lt, tl, tm, fresh);
+                    nodes[nv].lt = lt;
+                } else if (ql > tm) {
+                    const int rt = update(ql, qr, extra, nodes[nv].rt, tm+1, tr, fresh);
+                    nodes[nv].rt = rt;
+                } else {
+                    const int lt = update(ql, tm, extra, nodes[nv].lt, tl, tm, fresh);
+                    const int rt = update(tm+1, qr, extra, nodes[nv].rt, tm+1, tr, fresh);
+                    nodes[nv].lt = lt;
+                    nodes[nv].rt = rt;
+                }
+                pull(nv, tl, tr, tm);
+            }
+            return nv;
+        }
+
+        /*******************************************************************************
+         *  Creates new version from current one, makes it current and returns it
+         ******************************************************************************/
+        int update(const ll ql, const ll qr, const Extra& extra) {
+            const int root = update(ql, qr, extra, roots[cur], 0, n-1, size());
+            roots.push_back(root);
+            return cur = versions()-1;
+        }
+
+    };
+
+} // namespace PersistentLazySegmentTree
+} // namespace algos
+#endif // __PERSISTENTLAZYSEGMENTTREE_HPP__
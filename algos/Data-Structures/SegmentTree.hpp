@@ -1,5 +1,7 @@
 #ifndef __SEGMENTTREE_HPP__
 #define __SEGMENTTREE_HPP__
+#include <span>
+#include <cstring>
 namespace algos {
 /**
  *  Efficient template SegmentTree<ItemType, ItemTraits> bottom-to-top implementation.
@@ -79,8 +81,363 @@ namespace SegmentTree {
                 ItemTraits::merge(data[v], data[2*v], data[2*v+1]);
             }
         }
+        
+        /**
+         * Offline methods: update_batch(updates) applies all point updates in given order and then
+         * recalculates every dirty ancestor once per level; get_batch(queries) answers range queries
+         */
+        void update_batch(std::span<const std::pair<int, ItemType>> updates) {
+            std::vector<int> dirty;
+            dirty.reserve(updates.size());
+            for (const auto &[pos, val] : updates) {
+                ItemTraits::update(data[pos + n], val);
+                dirty.push_back((pos + n) / 2);
+            }
+            std::sort(dirty.begin(), dirty.end(), std::greater<int>());
+            // Parent of a bigger vertex is not less, so each level stays sorted after v /= 2:
+            while (!dirty.empty() && dirty.front() > 0) {
+                dirty.erase(std::unique(dirty.begin(), dirty.end()), dirty.end());
+                if (dirty.back() == 0) { dirty.pop_back(); }
+                for (auto &v : dirty) {
+                    ItemTraits::merge(data[v], data[2*v], data[2*v+1]);
+                    v /= 2;
+                }
+            }
+        }
+        
+        std::vector<ItemType> get_batch(std::span<const std::pair<int, int>> queries) const {
+            std::vector<ItemType> ret;
+            ret.reserve(queries.size());
+            for (const auto &[ql, qr] : queries) {
+                ret.push_back(get(ql, qr));
+            }
+            return ret;
+        }
+        
+        /**
+         * Descent methods, `pred(neutral)` must be true and `pred` must be monotone:
+         *   max_right(l, pred) - first r >= l such that pred(get(l, r)) is false, or n if there is no such r
+         *   min_left(r, pred)  - first l <= r+1 such that pred(get(l, r)) is true (get(r+1, r) is neutral)
+         */
+        template<typename Pred>
+        int max_right(int ql, Pred pred) const {
+            // nodes covering [ql, n-1], ordered from left to right:
+            int nodes[64], cnt = 0, rt[32], cntR = 0;
+            for (int l = ql + n, r = 2 * n - 1; l <= r; l /= 2, r /= 2) {
+                if (l % 2 == 1) { nodes[cnt++] = l++; }
+                if (r % 2 == 0) { rt[cntR++] = r--; }
+            }
+            while (cntR > 0) { nodes[cnt++] = rt[--cntR]; }
+            ItemType acc = ItemTraits::neutral(), tmp;
+            for (int i = 0; i < cnt; i++) {
+                int v = nodes[i];
+                ItemTraits::merge(tmp, acc, data[v]);
+                if (pred(tmp)) { acc = tmp; continue; }
+                while (v < n) {
+                    ItemTraits::merge(tmp, acc, data[2*v]);
+                    if (pred(tmp)) { acc = tmp; v = 2*v+1; }
+                    else { v = 2*v; }
+                }
+                return v - n;
+            }
+            return n;
+        }
+        
+        template<typename Pred>
+        int min_left(int qr, Pred pred) const {
+            // nodes covering [0, qr], ordered from right to left:
+            int nodes[64], cnt = 0, lt[32], cntL = 0;
+            for (int l = n, r = qr + n; l <= r; l /= 2, r /= 2) {
+                if (l % 2 == 1) { lt[cntL++] = l++; }
+                if (r % 2 == 0) { nodes[cnt++] = r--; }
+            }
+            while (cntL > 0) { nodes[cnt++] = lt[--cntL]; }
+            ItemType acc = ItemTraits::neutral(), tmp;
+            for (int i = 0; i < cnt; i++) {
+                int v = nodes[i];
+                ItemTraits::merge(tmp, data[v], acc);
+                if (pred(tmp)) { acc = tmp; continue; }
+                while (v < n) {
+                    ItemTraits::merge(tmp, data[2*v+1], acc);
+                    if (pred(tmp)) { acc = tmp; v = 2*v; }
+                    else { v = 2*v+1; }
+                }
+                return v - n + 1;
+            }
+            return 0;
+        }
     }; /** SegmentTree class end */
     
+    /**
+     * SegmentTreeWide class. Bottom-to-top implementation with B-ary nodes (B = Arity): each level is
+     * stored contiguously and padded to a multiple of B, so the children of one node share a cache line
+     * (Arity = 64 / sizeof(ItemType) by default). Tree has only log_B(n) levels, so queries on big
+     * arrays make much less cache misses. Same ItemTraits and same methods as SegmentTree above
+     */
+    template<typename ItemType = int64_t, typename ItemTraits = TraitsMinSet<ItemType>,
+             int Arity = std::max(2, int(64 / sizeof(ItemType)))>
+    struct SegmentTreeWide {
+        static_assert(Arity >= 2, "Arity must be at least 2");
+        
+        /**
+         * Public data: `n` - number of items in array, `data` - tree's container,
+         * `offset[k]` - position of k-th level in `data` (level 0 contains items).
+         * bool items are stored as char, because std::vector<bool> has no addressable items
+         */
+        using Storage = std::conditional_t<std::is_same_v<ItemType, bool>, char, ItemType>;
+        int n; std::vector<Storage> data; std::vector<int> offset;
+        
+        /**
+         * Main methods: resize(nItems), build(array), get(left, right), where 0 <= left <= right < nItems
+         */
+        void resize(const int n_) {
+            n = n_;
+            offset.assign(1, 0);
+            int size = std::max(n, 1);
+            while (true) {
+                size = (size + Arity - 1) / Arity * Arity;
+                offset.push_back(offset.back() + size);
+                if (size == Arity) { break; }
+                size /= Arity;
+            }
+            // the last level is a single root node:
+            offset.push_back(offset.back() + 1);
+            data.assign(offset.back(), ItemTraits::neutral());
+        }
+        
+        void pull(const int level, const int v) {
+            const Storage *child = &data[offset[level-1] + v * Arity];
+            ItemType res = ItemTraits::neutral();
+            for (int i = 0; i < Arity; ++i) {
+                ItemTraits::merge(res, res, child[i]);
+            }
+            data[offset[level] + v] = res;
+        }
+        
+        template<typename T>
+        void build(const std::vector<T>& arr) {
+            resize((int)arr.size());
+            for (int v = 0; v < n; ++v) {
+                data[v] = arr[v];
+            }
+            for (int k = 1; k < (int)offset.size() - 1; ++k) {
+                for (int v = 0; v < (offset[k] - offset[k-1]) / Arity; ++v) {
+                    pull(k, v);
+                }
+            }
+        }
+        
+        ItemType get(int ql, int qr) const {
+            ItemType ret = ItemTraits::neutral();
+            for (int k = 0; ql <= qr; ++k, ql = ql / Arity + 1, qr = qr / Arity - 1) {
+                const Storage *level = &data[offset[k]];
+                if (ql / Arity == qr / Arity) {
+                    for (int v = ql; v <= qr; ++v) { ItemTraits::merge(ret, ret, level[v]); }
+                    break;
+                }
+                for (int v = ql, end = (ql / Arity + 1) * Arity; v < end; ++v) {
+                    ItemTraits::merge(ret, ret, level[v]);
+                }
+                for (int v = qr / Arity * Arity; v <= qr; ++v) {
+                    ItemTraits::merge(ret, ret, level[v]);
+                }
+            }
+            return ret;
+        }
+        
+        void update(int pos, ItemType val) {
+            ItemType item = data[pos];
+            ItemTraits::update(item, val);
+            data[pos] = item;
+            for (int k = 1; k < (int)offset.size() - 1; ++k) {
+                pos /= Arity;
+                pull(k, pos);
+            }
+        }
+    }; /** SegmentTreeWide class end */
+    
+    /**
+     * SegmentTree2D class. Bottom-to-top implementation on n x m grid: outer tree over rows, where each
+     * node is a bottom-to-top segment tree over columns. All nodes are stored in one row-major vector,
+     * so the inner tree of one outer node is contiguous. Uses same ItemTraits as SegmentTree above
+     */
+    template<typename ItemType = int64_t, typename ItemTraits = TraitsMinSet<ItemType>>
+    struct SegmentTree2D {
+        /**
+         * Public data: `n` x `m` - sizes of grid and `data` - tree's container
+         */
+        int n, m; std::vector<ItemType> data;
+        
+        ItemType& at(int x, int y) { return data[(size_t)x * 2 * m + y]; }
+        
+        const ItemType& at(int x, int y) const { return data[(size_t)x * 2 * m + y]; }
+        
+        /**
+         * Main methods: resize(nRows, nCols), build(2D array), get(x1, y1, x2, y2), update(x, y, value)
+         */
+        void resize(const int n_, const int m_) {
+            n = n_, m = m_;
+            data.assign((size_t)4 * n * m, ItemTraits::neutral());
+        }
+        
+        template<typename T>
+        void build(const std::vector<std::vector<T>>& arr) {
+            resize((int)arr.size(), arr.empty() ? 0 : (int)arr[0].size());
+            for (int x = 0; x < n; ++x) {
+                for (int y = 0; y < m; ++y) {
+                    at(x + n, y + m) = arr[x][y];
+                }
+                for (int y = m-1; y >= 1; --y) {
+                    ItemTraits::merge(at(x + n, y), at(x + n, 2*y), at(x + n, 2*y+1));
+                }
+            }
+            for (int x = n-1; x >= 1; --x) {
+                for (int y = 1; y < 2 * m; ++y) {
+                    ItemTraits::merge(at(x, y), at(2*x, y), at(2*x+1, y));
+                }
+            }
+        }
+        
+        ItemType getRow(int x, int ql, int qr) const {
+            ItemType ret = ItemTraits::neutral();
+            for (ql += m, qr += m; ql <= qr; ql /= 2, qr /= 2) {
+                if (ql % 2 == 1) { ItemTraits::merge(ret, ret, at(x, ql++)); }
+                if (qr % 2 == 0) { ItemTraits::merge(ret, ret, at(x, qr--)); }
+            }
+            return ret;
+        }
+        
+        ItemType get(int x1, int y1, int x2, int y2) const {
+            ItemType ret = ItemTraits::neutral();
+            for (x1 += n, x2 += n; x1 <= x2; x1 /= 2, x2 /= 2) {
+                if (x1 % 2 == 1) { ItemTraits::merge(ret, ret, getRow(x1++, y1, y2)); }
+                if (x2 % 2 == 0) { ItemTraits::merge(ret, ret, getRow(x2--, y1, y2)); }
+            }
+            return ret;
+        }
+        
+        void update(int x, int y, ItemType val) {
+            x += n, y += m;
+            ItemTraits::update(at(x, y), val);
+            for (int v = y / 2; v > 0; v /= 2) {
+                ItemTraits::merge(at(x, v), at(x, 2*v), at(x, 2*v+1));
+            }
+            for (x /= 2; x > 0; x /= 2) {
+                for (int v = y; v > 0; v /= 2) {
+                    ItemTraits::merge(at(x, v), at(2*x, v), at(2*x+1, v));
+                }
+            }
+        }
+    }; /** SegmentTree2D class end */
+    
+    /**
+     * SimdKind<ItemTraits>::value - which reduction `merge` of traits does: min, max, sum or none.
+     * Specializations for arithmetic traits are given below, after definitions of traits
+     */
+    enum class SimdReduce { None, Min, Max, Sum };
+    
+    template<typename ItemTraits>
+    struct SimdKind { static constexpr SimdReduce value = SimdReduce::None; };
+    
+    /**
+     * SimdSegmentTree class. SegmentTreeWide with cache-line nodes, where each node is reduced by
+     * vector instructions: a partial block on the query's border is masked by neutral elements instead
+     * of being merged item by item. Works for arithmetic ItemType and traits with known SimdKind
+     * (min, max or sum on segment). Vector path needs `__AVX2__` (-mavx2 or `#pragma GCC target("avx2")`),
+     * otherwise scalar loops. It is opt-in: SegmentTree is not changed, use SimdSegmentTree or
+     * SegmentTreeFast explicitly.
+     */
+    template<typename ItemType, typename ItemTraits>
+    struct SimdSegmentTree : public SegmentTreeWide<ItemType, ItemTraits, int(64 / sizeof(ItemType))> {
+        static constexpr SimdReduce kind = SimdKind<ItemTraits>::value;
+        static_assert(kind != SimdReduce::None, "SimdSegmentTree supports only min, max and sum traits");
+        static_assert(std::is_arithmetic_v<ItemType> && !std::is_same_v<ItemType, bool>,
+                      "SimdSegmentTree supports only arithmetic types except bool");
+        static_assert(64 % sizeof(ItemType) == 0 && sizeof(ItemType) <= 8, "Unsupported item size");
+        
+        static constexpr int Arity = int(64 / sizeof(ItemType));
+        using Base = SegmentTreeWide<ItemType, ItemTraits, Arity>;
+        using Base::n, Base::data, Base::offset, Base::resize, Base::build;
+        
+        template<typename V>
+        static V apply(const V& lhs, const V& rhs) {
+            if constexpr (kind == SimdReduce::Min) { return lhs < rhs ? lhs : rhs; }
+            else if constexpr (kind == SimdReduce::Max) { return lhs < rhs ? rhs : lhs; }
+            else { return lhs + rhs; }
+        }
+        
+        /**
+         * Reduction of items block[from..to] of one node, 0 <= from <= to < Arity
+         */
+        static ItemType reduce(const ItemType *block, const int from, const int to) {
+        #ifdef __AVX2__
+            constexpr int Lanes = int(32 / sizeof(ItemType));
+            using Index = std::conditional_t<sizeof(ItemType) == 8, int64_t,
+                          std::conditional_t<sizeof(ItemType) == 4, int32_t,
+                          std::conditional_t<sizeof(ItemType) == 2, int16_t, int8_t>>>;
+            typedef ItemType Vec __attribute__((vector_size(32)));
+            typedef Index Mask __attribute__((vector_size(32)));
+            Mask idx;
+            for (int i = 0; i < Lanes; ++i) { idx[i] = Index(i); }
+            const Mask lo = Mask{} + Index(from), hi = Mask{} + Index(to);
+            const Vec neutral = Vec{} + ItemTraits::neutral();
+            Vec lt, rt;
+            std::memcpy(&lt, block, 32);
+            std::memcpy(&rt, block + Lanes, 32);
+            lt = ((idx >= lo) & (idx <= hi)) ? lt : neutral;
+            idx += Index(Lanes);
+            rt = ((idx >= lo) & (idx <= hi)) ? rt : neutral;
+            const Vec res = apply(lt, rt);
+            ItemType ret = res[0];
+            for (int i = 1; i < Lanes; ++i) { ret = apply(ret, res[i]); }
+            return ret;
+        #else
+            ItemType ret = ItemTraits::neutral();
+            for (int i = from; i <= to; ++i) { ret = apply(ret, block[i]); }
+            return ret;
+        #endif
+        }
+        
+        void pull(const int level, const int v) {
+            data[offset[level] + v] = reduce(&data[offset[level-1] + v * Arity], 0, Arity-1);
+        }
+        
+        ItemType get(int ql, int qr) const {
+            ItemType ret = ItemTraits::neutral();
+            for (int k = 0; ql <= qr; ++k, ql = ql / Arity + 1, qr = qr / Arity - 1) {
+                const ItemType *level = &data[offset[k]];
+                const int bl = ql / Arity * Arity, br = qr / Arity * Arity;
+                if (bl == br) {
+                    ret = apply(ret, reduce(level + bl, ql - bl, qr - bl));
+                    break;
+                }
+                ret = apply(ret, reduce(level + bl, ql - bl, Arity-1));
+                ret = apply(ret, reduce(level + br, 0, qr - br));
+            }
+            return ret;
+        }
+        
+        void update(int pos, ItemType val) {
+            ItemTraits::update(data[pos], val);
+            for (int k = 1; k < (int)offset.size() - 1; ++k) {
+                pos /= Arity;
+                pull(k, pos);
+            }
+        }
+    }; /** SimdSegmentTree class end */
+    
+    /**
+     * SegmentTreeFast<ItemType, ItemTraits> - SimdSegmentTree when traits are min/max/sum on arithmetic type
+     * (not bool), SegmentTreeWide otherwise. Selection is by this alias only, SegmentTree is not dispatched
+     */
+    template<typename ItemType, typename ItemTraits>
+    using SegmentTreeFast = std::conditional_t<
+        SimdKind<ItemTraits>::value != SimdReduce::None && std::is_arithmetic_v<ItemType>
+            && !std::is_same_v<ItemType, bool> && 64 % sizeof(ItemType) == 0 && sizeof(ItemType) <= 8,
+        SimdSegmentTree<ItemType, ItemTraits>,
+        SegmentTreeWide<ItemType, ItemTraits>
+    >;
+    
     template<typename ItemType = int64_t, typename ItemTraits = TraitsMinSet<ItemType>>
     struct SegmentTreeRecursive {
         
@@ -230,6 +587,16 @@ namespace SegmentTree {
         static void merge(T& dst, const T& lhs, const T& rhs) { dst = std::__gcd(lhs, rhs); }
     };
     
+    /**
+     * Arithmetic traits which could be reduced by SimdSegmentTree
+     */
+    template<typename T> struct SimdKind<TraitsMinSet<T>> { static constexpr SimdReduce value = SimdReduce::Min; };
+    template<typename T> struct SimdKind<TraitsMaxSet<T>> { static constexpr SimdReduce value = SimdReduce::Max; };
+    template<typename T> struct SimdKind<TraitsSumSet<T>> { static constexpr SimdReduce value = SimdReduce::Sum; };
+    template<typename T> struct SimdKind<TraitsMinAdd<T>> { static constexpr SimdReduce value = SimdReduce::Min; };
+    template<typename T> struct SimdKind<TraitsMaxAdd<T>> { static constexpr SimdReduce value = SimdReduce::Max; };
+    template<typename T> struct SimdKind<TraitsSumAdd<T>> { static constexpr SimdReduce value = SimdReduce::Sum; };
+    
 } /** SegmentTree namespace end */
 } // namespace algos
 #endif // __SEGMENTTREE_HPP__
\ No newline at end of file
@@ -183,9 +183,267 @@ using namespace algos::SegmentTreeLazyTraits;
         void update(const int ql, const int qr, const Extra& extra) {
             update(ql, qr, extra, 0, 0, n-1); 
         }
+        
+        /*******************************************************************************
+         *  Merge accumulated node `acc` on [ql, tl-1] with node `v` on [tl, tr]
+         ******************************************************************************/
+        Node mergeRight(const Node& acc, const int ql, const int v, const int tl, const int tr) const {
+            if (ql == tl) { return Node(data[v].getValue(tl, tr)); }
+            Node ret;
+            Traits::pull(
+                NodeWrapper<Node&>(ql, tr, ret),
+                NodeWrapper<const Node&>(ql, tl-1, acc),
+                NodeWrapper<const Node&>(tl, tr, data[v])
+            );
+            return ret;
+        }
+        
+        Node mergeLeft(const int v, const int tl, const int tr, const Node& acc, const int qr) const {
+            if (qr == tr) { return Node(data[v].getValue(tl, tr)); }
+            Node ret;
+            Traits::pull(
+                NodeWrapper<Node&>(tl, qr, ret),
+                NodeWrapper<const Node&>(tl, tr, data[v]),
+                NodeWrapper<const Node&>(tr+1, qr, acc)
+            );
+            return ret;
+        }
+        
+        /*******************************************************************************
+         *  Descent queries, `pred(valueNeutral)` must be true and `pred` must be monotone:
+         *      max_right(l, pred) - first r >= l such that pred(get(l, r)) is false, or n;
+         *      min_left(r, pred)  - first l <= r+1 such that pred(get(l, r)) is true.
+         *  Return -1 from recursive versions if the answer is not in [tl, tr]
+         ******************************************************************************/
+        template<typename Pred>
+        int max_right(const int ql, Pred& pred, Node& acc, const int v, const int tl, const int tr) {
+            if (tr < ql) { return -1; }
+            if (ql <= tl) {
+                Node next = mergeRight(acc, ql, v, tl, tr);
+                if (pred(next.value)) { acc = next; return -1; }
+                if (tl == tr) { return tl; }
+            }
+            const int tm = (tl + tr) / 2;
+            push(v, tl, tr, tm);
+            int ret = max_right(ql, pred, acc, v+1, tl, tm);
+            if (ret == -1) { ret = max_right(ql, pred, acc, v+2*(tm-tl+1), tm+1, tr); }
+            pull(v, tl, tr, tm);
+            return ret;
+        }
+        
+        template<typename Pred>
+        int max_right(const int ql, Pred pred) {
+            if (ql >= n) { return n; }
+            Node acc;
+            const int ret = max_right(ql, pred, acc, 0, 0, n-1);
+            return ret == -1 ? n : ret;
+        }
+        
+        template<typename Pred>
+        int min_left(const int qr, Pred& pred, Node& acc, const int v, const int tl, const int tr) {
+            if (tl > qr) { return -1; }
+            if (tr <= qr) {
+                Node next = mergeLeft(v, tl, tr, acc, qr);
+                if (pred(next.value)) { acc = next; return -1; }
+                if (tl == tr) { return tl + 1; }
+            }
+            const int tm = (tl + tr) / 2;
+            push(v, tl, tr, tm);
+            int ret = min_left(qr, pred, acc, v+2*(tm-tl+1), tm+1, tr);
+            if (ret == -1) { ret = min_left(qr, pred, acc, v+1, tl, tm); }
+            pull(v, tl, tr, tm);
+            return ret;
+        }
+        
+        template<typename Pred>
+        int min_left(const int qr, Pred pred) {
+            if (qr < 0) { return 0; }
+            Node acc;
+            const int ret = min_left(qr, pred, acc, 0, 0, n-1);
+            return ret == -1 ? 0 : ret;
+        }
 
     };
     
+    /*******************************************************************************
+     *  SegmentTreeIterative<Value, Extra, Traits> - non-recursive segment tree with
+     *  lazy propagation on the same Traits as SegmentTree above, 0-indexed.
+     *  Nodes are stored in heap order on `size` = 2^LOG leaves:
+     *      1)  update pushes extras down along two boundary paths, applies extra to
+     *          covering nodes and pulls values up along the same paths;
+     *      2)  get is const: it does not push, but composes extras of ancestors of
+     *          boundary leaves top-down and applies them to covering nodes.
+     ******************************************************************************/
+    template<typename Value = int64_t, typename Extra = int64_t, typename Traits = TraitsMinAdd<Value, Extra> >
+    struct SegmentTreeIterative {
+        
+        using Node = typename SegmentTree<Value, Extra, Traits>::Node;
+        
+        template<typename NodeType>
+        using NodeWrapper = typename SegmentTree<Value, Extra, Traits>::template NodeWrapper<NodeType>;
+        
+        /*******************************************************************************
+         *  Public data: n - number of items, size = 2^LOG >= n, data - vector for nodes
+         ******************************************************************************/
+        int n, LOG, size; std::vector<Node> data;
+        
+        /*******************************************************************************
+         *  Resize segment tree data to needed size
+         ******************************************************************************/
+        void resize(int n_) {
+            n = n_;
+            LOG = 0;
+            while ((1 << LOG) < n) { LOG++; }
+            size = (1 << LOG);
+            data.assign(2 * size, Node());
+        }
+        
+        /*******************************************************************************
+         *  Segment [left, right] covered by node `v` at height `h`
+         ******************************************************************************/
+        int left(int v, int h) const { return (v - (size >> h)) << h; }
+        
+        int right(int v, int h) const { return left(v, h) + (1 << h) - 1; }
+        
+        /*******************************************************************************
+         *  Lazy propagation from node `v` at height `h` to its children
+         ******************************************************************************/
+        void push(int v, int h) {
+            if (data[v].extra != Traits::extraNeutral()) {
+                const NodeWrapper<const Node&> src(left(v, h), right(v, h), data[v]);
+                Traits::push(NodeWrapper<Node&>(left(2*v, h-1), right(2*v, h-1), data[2*v]), src);
+                Traits::push(NodeWrapper<Node&>(left(2*v+1, h-1), right(2*v+1, h-1), data[2*v+1]), src);
+                data[v].extra = Traits::extraNeutral();
+            }
+        }
+        
+        /*******************************************************************************
+         *  Update node `v` at height `h` using children values
+         ******************************************************************************/
+        void pull(int v, int h) {
+            assert(data[v].extra == Traits::extraNeutral());
+            Traits::pull(
+                NodeWrapper<Node&>(left(v, h), right(v, h), data[v]),
+                NodeWrapper<const Node&>(left(2*v, h-1), right(2*v, h-1), data[2*v]),
+                NodeWrapper<const Node&>(left(2*v+1, h-1), right(2*v+1, h-1), data[2*v+1])
+            );
+        }
+        
+        /*******************************************************************************
+         *  Build segtree from array with given values
+         ******************************************************************************/
+        template<typename T>
+        void build(const std::vector<T>& arr) {
+            resize((int)arr.size());
+            for (int i = 0; i < n; i++) {
+                data[size + i] = Node(arr[i]);
+            }
+            for (int h = 1; h <= LOG; h++) {
+                for (int v = (size >> h); v < (size >> (h-1)); v++) {
+                    pull(v, h);
+                }
+            }
+        }
+        
+        /*******************************************************************************
+         *  Get-query on range [ql, qr]
+         ******************************************************************************/
+        Value get(int ql, int qr) const {
+            const int L = ql + size, R = qr + size + 1;
+            // Composition of extras of all proper ancestors of nodes at current height
+            // on paths to leaves `ql` and `qr`, built in one pass from root to leaves:
+            Node accL, accR;
+            auto descend = [&](Node& acc, const int leaf, const int h) {
+                const int v = leaf >> h;
+                Node next = data[v];
+                if (acc.extra != Traits::extraNeutral()) {
+                    Traits::push(
+                        NodeWrapper<Node&>(left(v, h), right(v, h), next),
+                        NodeWrapper<const Node&>(left(v, h), right(v, h), acc)
+                    );
+                }
+                acc = next;
+            };
+            // Value of covering node `v` at height `h` with extras of ancestors:
+            auto effective = [&](const int v, const int h) {
+                Node node = data[v];
+                const Node& acc = ((L >> (h+1)) == (v >> 1) ? accL : accR);
+                if (h < LOG && acc.extra != Traits::extraNeutral()) {
+                    Traits::push(
+                        NodeWrapper<Node&>(left(v, h), right(v, h), node),
+                        NodeWrapper<const Node&>(left(v, h), right(v, h), acc)
+                    );
+                }
+                return Node(node.getValue(left(v, h), right(v, h)));
+            };
+            auto merge = [&](Node& res, const Node& lt, const int l, const int m, const Node& rt, const int r) {
+                if (l > m) { res = rt; }
+                else if (m + 1 > r) { res = lt; }
+                else {
+                    Node tmp;
+                    Traits::pull(
+                        NodeWrapper<Node&>(l, r, tmp),
+                        NodeWrapper<const Node&>(l, m, lt),
+                        NodeWrapper<const Node&>(m+1, r, rt)
+                    );
+                    res = tmp;
+                }
+            };
+            // Covering nodes from root to leaves: left ones are prepended to resL
+            // covering [beginL, endL], right ones are appended to resR covering [beginR, endR]
+            Node resL, resR; int beginL = qr + 1, endL = qr, beginR = ql, endR = ql - 1;
+            for (int h = LOG; h >= 0; h--) {
+                if (h < LOG) {
+                    descend(accL, L, h+1);
+                    descend(accR, qr + size, h+1);
+                }
+                const int l = (L + (1 << h) - 1) >> h, r = R >> h;
+                if (l >= r) { continue; }
+                if (l & 1) {
+                    if (beginL > endL) { endL = right(l, h); }
+                    merge(resL, effective(l, h), left(l, h), right(l, h), resL, endL);
+                    beginL = left(l, h);
+                }
+                if (r & 1) {
+                    if (beginR > endR) { beginR = left(r-1, h); }
+                    merge(resR, resR, beginR, endR, effective(r-1, h), right(r-1, h));
+                    endR = right(r-1, h);
+                }
+            }
+            merge(resL, resL, beginL, endL, resR, endR);
+            return resL.value;
+        }
+        
+        /*******************************************************************************
+         *  Update query on range [ql, qr] by extra
+         ******************************************************************************/
+        void update(int ql, int qr, const Extra& extra) {
+            const int l0 = ql + size, r0 = qr + size + 1;
+            for (int h = LOG; h >= 1; h--) {
+                if (((l0 >> h) << h) != l0) { push(l0 >> h, h); }
+                if (((r0 >> h) << h) != r0) { push((r0 - 1) >> h, h); }
+            }
+            const Node src(Traits::valueNeutral(), extra);
+            for (int l = l0, r = r0, h = 0; l < r; l >>= 1, r >>= 1, h++) {
+                if (l & 1) {
+                    Traits::push(NodeWrapper<Node&>(left(l, h), right(l, h), data[l]),
+                                 NodeWrapper<const Node&>(ql, qr, src));
+                    l++;
+                }
+                if (r & 1) {
+                    --r;
+                    Traits::push(NodeWrapper<Node&>(left(r, h), right(r, h), data[r]),
+                                 NodeWrapper<const Node&>(ql, qr, src));
+                }
+            }
+            for (int h = 1; h <= LOG; h++) {
+                if (((l0 >> h) << h) != l0) { pull(l0 >> h, h); }
+                if (((r0 >> h) << h) != r0) { pull((r0 - 1) >> h, h); }
+            }
+        }
+        
+    };
+    
 } // namespace SegmentTreeLazy
 } // namespace algos
 #endif // __SEGMENTTREELAZY_HPP__
\ No newline at end of file
@@ -74,6 +74,92 @@ struct SparseTable {
     
 };
 
+/**
+ *  LinearSparseTable - O(n) memory and O(1) query for selecting functions (min, max and
+ *  others which return one of their arguments). Array is split on blocks of 64 items:
+ *  each item keeps bitmask of suffix minima of its block prefix (answer inside block is
+ *  the lowest bit of mask), SparseTable is built over block answers only.
+ */
+template<typename T, typename Func, bool useFunctor = false>
+struct LinearSparseTable {
+
+    static const int B = 64;
+    
+    std::vector<T> a;
+    
+    std::vector<uint64_t> mask;
+    
+    SparseTable<T, Func, useFunctor> blocks;
+    
+    Func func;
+    
+    LinearSparseTable(const Func &func_ = Func())
+        : blocks(func_), func(func_)
+    {}
+    
+    LinearSparseTable(const auto &vec, const Func &func_ = Func())
+        : blocks(func_), func(func_)
+    { build(vec); }
+    
+    Func getFunc() const {
+        return (useFunctor ? func : Func());
+    }
+    
+    void build(const auto &vec) {
+        a.assign(std::begin(vec), std::end(vec));
+        const int n = isz(a);
+        mask.assign(n, 0);
+        std::vector<T> best((n + B - 1) / B);
+        for (int i = 0; i < n; i++) {
+            uint64_t curr = (i % B == 0 ? 0 : mask[i-1]);
+            // remove items, which are not better than a[i]:
+            while (curr) {
+                const int j = i / B * B + 63 - __builtin_clzll(curr);
+                if (!(getFunc()(a[i], a[j]) == a[i])) break;
+                curr ^= (1ULL << (j % B));
+            }
+            mask[i] = curr | (1ULL << (i % B));
+            best[i / B] = a[i / B * B + __builtin_ctzll(mask[i])];
+        }
+        if (n > 0) blocks.build(best);
+    }
+    
+    // answer inside one block, L and R are in the same block
+    T inBlock(int L, int R) const {
+        return a[L / B * B + __builtin_ctzll(mask[R] & (~0ULL << (L % B)))];
+    }
+    
+    T calcFunc(int L, int R) const {
+        assert(L <= R); // отрезок [L, R] - корректный
+        const int bL = L / B, bR = R / B;
+        if (bL == bR)
+            return inBlock(L, R);
+        T value = getFunc()(inBlock(L, bL * B + B - 1), inBlock(bR * B, R));
+        if (bL + 1 < bR)
+            value = getFunc()(value, blocks(bL + 1, bR - 1));
+        return value;
+    }
+    
+    T operator()(int L, int R) const {
+        return calcFunc(L, R);
+    }
+    
+    int binary_lifting(int pos, auto decideMoveRight) const {
+        T value = getFunc().neutral();
+        for (int p = std::__lg(std::max(isz(a), 1)); p >= 0; p--) {
+            if (pos + (1 << p) - 1 >= isz(a))
+                continue; // вышли за пределы массива
+            T nextValue = getFunc()(value, calcFunc(pos, pos + (1 << p) - 1));
+            if (decideMoveRight(nextValue)) {
+                pos += (1 << p);
+                value = nextValue;
+            }
+        }
+        return pos;
+    }
+    
+};
+
 struct MultByModulo {
     
     int mod;
@@ -0,0 +1,68 @@
+#ifndef __SUBSETSUM_HPP__
+#define __SUBSETSUM_HPP__
+#include "bitset.hpp"
+
+/**
+ *  SubsetSum - reachable subset sums in [0, maxSum] on Bitset with runtime size.
+ *  Each item is one fused pass dp |= dp << w over words (orShiftedUp), only words
+ *  up to the largest reachable sum are touched. Item repeated cnt times is split
+ *  into parts 1, 2, 4, ..., rest (binary splitting): O(log cnt) passes instead of cnt.
+ *  Time: O(maxSum / 64) per pass, with AVX2 four words per instruction.
+ *  Usage: SubsetSum ss(maxSum); ss.add(w, cnt); ss.addAll(weights); ss.test(s);
+ */
+struct SubsetSum {
+
+    int maxSum;
+
+    ll reach{}; // sum of all added weights, sums above it are unreachable
+
+    Bitset dp;
+
+    SubsetSum(int maxSum_ = 0) : maxSum(maxSum_), dp(maxSum_ + 1) { dp.set(0); }
+
+    // Add item with weight w (dp |= dp << w):
+    void addOne(ll w) {
+        assert(w >= 0);
+        reach += w;
+        if (w == 0 || w > maxSum) return;
+        const int words = int(std::min<ll>(reach, maxSum) / 64 + 1);
+        orShiftedUp(&dp.data[0], words, int(w / 64), int(w % 64));
+        dp.updateLastGroup();
+    }
+
+    // Add item with weight w, repeated cnt times, by binary splitting:
+    void add(ll w, ll cnt = 1) {
+        for (ll part = 1; cnt > 0; part *= 2) {
+            const ll take = std::min(part, cnt);
+            addOne(w * take);
+            cnt -= take;
+        }
+    }
+
+    // Add all items, equal weights are grouped:
+    void addAll(std::vector<int> weights) {
+        std::sort(weights.begin(), weights.end());
+        for (int i = 0, j = 0; i < (int)weights.size(); i = j) {
+            while (j < (int)weights.size() && weights[j] == weights[i]) j++;
+            add(weights[i], j - i);
+        }
+    }
+
+    bool test(int s) const { return 0 <= s && s <= maxSum && dp.test(s); }
+
+    bool operator[](int s) const { return test(s); }
+
+    // Largest reachable sum not greater than limit (0 is always reachable), -1 if limit < 0:
+    int maxReachable(int limit) const {
+        if (limit < 0) return -1;
+        limit = std::min(limit, maxSum);
+        int g = limit / 64;
+        uint64_t x = dp.data[g] & (~0ULL >> (63 - limit % 64));
+        while (x == 0) x = dp.data[--g];
+        return g * 64 + 63 - __builtin_clzll(x);
+    }
+
+    // Number of reachable sums in [0, maxSum]:
+    int count() const { return dp.count(); }
+};
+#endif // __SUBSETSUM_HPP__
@@ -0,0 +1,119 @@
+/**
+ *  Benchmark: scalar, AVX2 and AVX-512 word kernels of Bitset.hpp on 10^3 ... 10^8 bits.
+ *  For every size each kernel processes about 10^9 bits in total, so the rows are
+ *  comparable:
+ *  count  - popcount of a (cntOnes, Bitset::count),
+ *  cntAND - popcount of (a & b),
+ *  apply  - a &= b (setBitAND),
+ *  shl    - a <<= 64 * 1 + 5 (shiftWordsUp), shr - a >>= 64 * 1 + 5 (shiftWordsDown),
+ *  orShl  - a |= a << (64 * 1 + 5) (orShiftedUp, Bitset::orShiftLeft),
+ *  isNone - all words are zero (allZero), isAll - all words are ones (allOnes),
+ *  both tests scan the whole array.
+ *  Kernels which are not supported by CPU or have no such version are printed as "-".
+ *  Usage: bitset-kernels [total bits per row = 10^9]
+ */
+#include "template.hpp"
+#include "timer.hpp"
+#include "bitset.hpp"
+
+// Keeps compiler from hoisting a kernel out of the repetition loop:
+inline void clobber(const void *p) { asm volatile("" : : "r"(p) : "memory"); }
+
+template<typename F>
+size_t measure(const int reps, F kernel) {
+    Timer timer;
+    timer.start();
+    for (int r = 0; r < reps; r++) {
+        kernel();
+    }
+    timer.finish();
+    return timer();
+}
+
+int main(int argc, char **argv) {
+    const double total = argc > 1 ? atof(argv[1]) : 1e9;
+    std::mt19937_64 gen(1);
+    const char *names[] = {"scalar", "AVX2", "AVX-512"};
+    const char *columns[] = {"count", "cntAND", "apply", "shl", "shr", "orShl", "isNone", "isAll"};
+    printf("%10s %8s", "bits", "kernel");
+    for (auto column : columns) { printf(" %8s", column); }
+    printf("   (ms)\n");
+    for (int bits = 1000; bits <= (int)1e8; bits *= 10) {
+        const int sz = (bits + 63) / 64;
+        std::vector<uint64_t> a(sz), b(sz), c(sz), zeros(sz, 0), ones(sz, ~0ULL);
+        for (int i = 0; i < sz; i++) { a[i] = gen(), b[i] = gen(), c[i] = a[i]; }
+        const int reps = std::max(1, int(total / bits));
+        ll checksum = 0, expected = 0;
+        for (int level = BitsetScalar; level <= BitsetAVX512; level++) {
+            const bool popcnt = level <= bitsetPopcntLevel, simd = level <= bitsetSimdLevel;
+            auto count = [&](){
+                int res = 0;
+                if (level == BitsetScalar) { res = countScalar<BitsetOpFirst>(a.data(), a.data(), sz); }
+                if (level == BitsetAVX2) { res = countAVX2<BitsetOpFirst>(a.data(), a.data(), sz); }
+                if (level == BitsetAVX512) { res = countAVX512<BitsetOpFirst>(a.data(), a.data(), sz); }
+                checksum += res;
+                clobber(a.data());
+            };
+            auto cntAnd = [&](){
+                int res = 0;
+                if (level == BitsetScalar) { res = countScalar<BitsetOpAND>(a.data(), b.data(), sz); }
+                if (level == BitsetAVX2) { res = countAVX2<BitsetOpAND>(a.data(), b.data(), sz); }
+                if (level == BitsetAVX512) { res = countAVX512<BitsetOpAND>(a.data(), b.data(), sz); }
+                checksum += res;
+                clobber(a.data());
+            };
+            auto apply = [&](){
+                if (level == BitsetScalar) { applyScalar<BitsetOpAND>(c.data(), b.data(), sz); }
+                if (level == BitsetAVX2) { applyAVX2<BitsetOpAND>(c.data(), b.data(), sz); }
+                if (level == BitsetAVX512) { applyAVX512<BitsetOpAND>(c.data(), b.data(), sz); }
+                clobber(c.data());
+            };
+            // Word shifts and tests have scalar and AVX2 versions only:
+            auto shl = [&](){
+                const int g = level == BitsetAVX2 ? shiftWordsUpAVX2(c.data(), sz, 1, 5) : sz;
+                shiftWordsUpScalar(c.data(), g, 1, 5);
+                clobber(c.data());
+            };
+            auto shr = [&](){
+                const int g = level == BitsetAVX2 ? shiftWordsDownAVX2(c.data(), sz, 0, 1, 5) : 0;
+                shiftWordsDownScalar(c.data(), sz, g, 1, 5);
+                clobber(c.data());
+            };
+            auto orShl = [&](){
+                const int g = level == BitsetAVX2 ? orShiftedUpAVX2(c.data(), sz, 1, 5) : sz;
+                orShiftedUpScalar(c.data(), g, 1, 5);
+                clobber(c.data());
+            };
+            auto isNone = [&](){
+                checksum += level == BitsetAVX2 ? allZeroAVX2(zeros.data(), sz) : allZeroScalar(zeros.data(), sz);
+                clobber(zeros.data());
+            };
+            auto isAll = [&](){
+                checksum += level == BitsetAVX2 ? allOnesAVX2(ones.data(), sz) : allOnesScalar(ones.data(), sz);
+                clobber(ones.data());
+            };
+            auto cell = [&](const bool supported, auto kernel) {
+                if (supported) {
+                    printf(" %8zu", measure(reps, kernel));
+                } else {
+                    printf(" %8s", "-");
+                }
+            };
+            printf("%10d %8s", bits, names[level]);
+            cell(popcnt, count);
+            cell(popcnt, cntAnd);
+            cell(simd, apply);
+            const bool words = simd && level <= BitsetAVX2;
+            cell(words, shl);
+            cell(words, shr);
+            cell(words, orShl);
+            cell(words, isNone);
+            cell(words, isAll);
+            printf("\n");
+            // Every level must add reps * (popcount(a) + popcount(a & b)), word tests add 2 * reps:
+            expected += ll(cntOnes(a.data(), sz) + cntAND(a.data(), b.data(), sz)) * reps * popcnt
+                      + 2LL * reps * words;
+        }
+        assert(checksum == expected);
+    }
+}
@@ -0,0 +1,59 @@
+/**
+ *  Benchmark: thread scaling of ConcurrentDSU::connect vs sequential DSU on two edge streams:
+ *  random - m random edges on n vertices,
+ *  adversarial - chain edges (i, i+1) dealt round-robin, so all threads keep linking
+ *  into the same growing set and contend on its root.
+ *  Usage: concurrent-dsu [maxThreads = hardware_concurrency] [n = 10^6] [m = 4 * 10^6]
+ *  Every row must print the same number of merges for one stream.
+ */
+#include <thread>
+#include "template.hpp"
+#include "timer.hpp"
+#include "dsu.hpp"
+using namespace algos::dsu;
+
+void run(const char *name, const int n, const std::vector<std::pair<int,int>> &edges, const int maxThreads) {
+    const int m = (int)edges.size();
+    Timer timer;
+    {
+        DSU dsu(n);
+        int merges = 0;
+        timer.start();
+        for (const auto &[u, v] : edges) {
+            merges += !dsu.isConnected(u, v);
+            dsu.connect(u, v);
+        }
+        timer.finish();
+        printf("%-11s sequential DSU: %5zu ms, merges = %d\n", name, timer(), merges);
+    }
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        ConcurrentDSU dsu(n);
+        std::vector<int> merges(threads);
+        std::vector<std::thread> workers;
+        timer.start();
+        for (int t = 0; t < threads; t++) {
+            workers.emplace_back([&, t](){
+                int cnt = 0;
+                for (int i = t; i < m; i += threads) { cnt += dsu.connect(edges[i].first, edges[i].second); }
+                merges[t] = cnt;
+            });
+        }
+        for (auto &it : workers) { it.join(); }
+        timer.finish();
+        printf("%-11s %2d threads:    %5zu ms, merges = %d\n", name, threads, timer(),
+               std::accumulate(merges.begin(), merges.end(), 0));
+    }
+}
+
+int main(int argc, char **argv) {
+    const int maxThreads = argc > 1 ? atoi(argv[1]) : std::max(1, (int)std::thread::hardware_concurrency());
+    const int n = argc > 2 ? atoi(argv[2]) : 1000000;
+    const int m = argc > 3 ? atoi(argv[3]) : 4000000;
+    std::mt19937 gen(1);
+    std::vector<std::pair<int,int>> edges(m);
+    for (auto &[u, v] : edges) { u = int(gen() % n), v = int(gen() % n); }
+    run("random", n, edges, maxThreads);
+    edges.resize(n-1);
+    for (int i = 0; i + 1 < n; i++) { edges[i] = {i, i+1}; }
+    run("adversarial", n, edges, maxThreads);
+}
@@ -0,0 +1,36 @@
+/**
+ *  Benchmark: memory per version and update time of PersistentLazySegmentTree
+ *  on random range-add updates over n items, for min-add and sum-add traits.
+ *  Usage: persistent-lazy-segment-tree [n = 10^6] [versions = 10^6]
+ */
+#include "template.hpp"
+#include "timer.hpp"
+#include "segmenttreelazytraits.hpp"
+#include "persistentlazysegmenttree.hpp"
+using namespace algos::PersistentLazySegmentTree;
+
+template<typename Traits>
+void run(const char *name, const int n, const int versions) {
+    SegmentTree<ll, ll, Traits> tree;
+    tree.build(std::vector<ll>(n, 1));
+    const int nodes0 = tree.size();
+    std::mt19937 gen(1);
+    Timer timer;
+    timer.start();
+    for (int i = 0; i < versions; i++) {
+        int l = int(gen() % n), r = int(gen() % n);
+        if (l > r) { std::swap(l, r); }
+        tree.update(l, r, ll(gen() % 1000));
+    }
+    timer.finish();
+    const double perVersion = double(tree.size() - nodes0) / versions;
+    printf("%-8s n = %d, versions = %d: %5zu ms, %.1f nodes (%.0f bytes) per version, checksum = %lld\n",
+           name, n, versions, timer(), perVersion, perVersion * sizeof(tree.nodes[0]), tree.get(0, n-1));
+}
+
+int main(int argc, char **argv) {
+    const int n = argc > 1 ? atoi(argv[1]) : 1000000;
+    const int versions = argc > 2 ? atoi(argv[2]) : 1000000;
+    run<TraitsMinAdd<ll, ll>>("min-add", n, versions);
+    run<LazySumAdd<ll, ll>>("sum-add", n, versions);
+}
@@ -0,0 +1,49 @@
+/**
+ *  Benchmark: SegmentTree::update_batch / get_batch vs loops of single update / get calls
+ *  on random point updates and random range-min queries.
+ *  Usage: segment-tree-batch [n = 10^6] [q = 10^7]
+ *  Both variants must print the same checksums.
+ */
+#include "template.hpp"
+#include "timer.hpp"
+#include "segmenttree.hpp"
+using namespace algos::SegmentTree;
+
+int main(int argc, char **argv) {
+    const int n = argc > 1 ? atoi(argv[1]) : 1000000;
+    const int q = argc > 2 ? atoi(argv[2]) : 10000000;
+    std::mt19937 gen(1);
+    std::vector<ll> arr(n);
+    for (auto &it : arr) { it = gen() % 1000000000; }
+    std::vector<std::pair<int, ll>> updates(q);
+    for (auto &[pos, val] : updates) { pos = int(gen() % n), val = gen() % 1000000000; }
+    std::vector<std::pair<int, int>> queries(q);
+    for (auto &[l, r] : queries) {
+        l = int(gen() % n), r = int(gen() % n);
+        if (l > r) { std::swap(l, r); }
+    }
+    using Tree = SegmentTree<ll, TraitsMinSet<ll>>;
+    Timer timer;
+    for (int batch = 0; batch < 2; batch++) {
+        Tree tree;
+        tree.build(arr);
+        timer.start();
+        if (batch) {
+            tree.update_batch(updates);
+        } else {
+            for (const auto &[pos, val] : updates) { tree.update(pos, val); }
+        }
+        timer.finish();
+        const size_t tUpdate = timer();
+        ll checksum = 0;
+        timer.start();
+        if (batch) {
+            for (ll it : tree.get_batch(queries)) { checksum += it; }
+        } else {
+            for (const auto &[l, r] : queries) { checksum += tree.get(l, r); }
+        }
+        timer.finish();
+        printf("%-7s n = %d, q = %d: update %5zu ms, get %5zu ms, checksum = %lld\n",
+               batch ? "batch" : "single", n, q, tUpdate, timer(), checksum);
+    }
+}
@@ -0,0 +1,37 @@
+/**
+ *  Benchmark: SegmentTreeIterative vs recursive SegmentTree from SegmentTreeLazy.hpp
+ *  on random min-add updates mixed with random min queries, 1:1.
+ *  Usage: segment-tree-lazy-iterative [n = 10^6] [q = 2*10^6]
+ *  Both trees must print the same checksum.
+ */
+#include "template.hpp"
+#include "timer.hpp"
+#include "segmenttreelazytraits.hpp"
+#include "segmenttreelazy.hpp"
+using namespace algos::SegmentTreeLazy;
+
+template<typename Tree>
+void run(const char *name, const int n, const int q) {
+    Tree tree;
+    tree.build(std::vector<ll>(n, 0));
+    std::mt19937 gen(1);
+    ll checksum = 0;
+    Timer timer;
+    timer.start();
+    for (int i = 0; i < q; i++) {
+        int l = int(gen() % n), r = int(gen() % n);
+        if (l > r) { std::swap(l, r); }
+        if (i % 2 == 0) { tree.update(l, r, ll(gen() % 21) - 10); }
+        else { checksum += tree.get(l, r); }
+    }
+    timer.finish();
+    printf("%-10s n = %d, q = %d: %5zu ms, checksum = %lld\n", name, n, q, timer(), checksum);
+}
+
+int main(int argc, char **argv) {
+    const int n = argc > 1 ? atoi(argv[1]) : 1000000;
+    const int q = argc > 2 ? atoi(argv[2]) : 2000000;
+    using Traits = TraitsMinAdd<ll, ll>;
+    run<SegmentTree<ll, ll, Traits>>("recursive", n, q);
+    run<SegmentTreeIterative<ll, ll, Traits>>("iterative", n, q);
+}
@@ -0,0 +1,44 @@
+/**
+ *  Benchmark: B-ary SegmentTreeWide vs binary bottom-to-top SegmentTree on n = 10^5 ... maxN,
+ *  random range-min queries and random point updates, 1:1.
+ *  Usage: segment-tree-wide [maxN = 10^8] [q = 10^7]
+ *  Both trees must print the same checksum for each n.
+ */
+#include "template.hpp"
+#include "timer.hpp"
+#include "segmenttree.hpp"
+using namespace algos::SegmentTree;
+
+template<typename Tree>
+void run(const char *name, const std::vector<int> &arr, const int q) {
+    const int n = (int)arr.size();
+    Tree tree;
+    tree.build(arr);
+    std::mt19937 gen(2);
+    ll checksum = 0;
+    Timer timer;
+    timer.start();
+    for (int i = 0; i < q; i++) {
+        if (i % 2 == 0) {
+            tree.update(int(gen() % n), int(gen() % 1000000000));
+        } else {
+            int l = int(gen() % n), r = int(gen() % n);
+            if (l > r) { std::swap(l, r); }
+            checksum += tree.get(l, r);
+        }
+    }
+    timer.finish();
+    printf("%-7s n = %9d, q = %d: %5zu ms, checksum = %lld\n", name, n, q, timer(), checksum);
+}
+
+int main(int argc, char **argv) {
+    const int maxN = argc > 1 ? atoi(argv[1]) : 100000000;
+    const int q = argc > 2 ? atoi(argv[2]) : 10000000;
+    std::mt19937 gen(1);
+    for (int n = 100000; n <= maxN; n *= 10) {
+        std::vector<int> arr(n);
+        for (auto &it : arr) { it = int(gen() % 1000000000); }
+        run<SegmentTree<int, TraitsMinSet<int>>>("binary", arr, q);
+        run<SegmentTreeWide<int, TraitsMinSet<int>>>("wide", arr, q);
+    }
+}
@@ -1,18 +1,168 @@
 #ifndef __FASTIO_HPP__
 #define __FASTIO_HPP__
+#include <cstring>
+#include <charconv>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define FASTIO_MMAP
+#endif
 
 namespace FastIO {
+    /**
+     *  SWAR parsing: 8 digits are loaded as one 64-bit word (first digit in the lowest
+     *  byte) and combined by three multiply-shift-mask steps instead of 8 steps.
+     */
+    // number of leading bytes in chunk which are digits:
+    inline int digitCount8(uint64_t chunk) {
+        const uint64_t bad = ((chunk + 0x4646464646464646ULL) | (chunk - 0x3030303030303030ULL)) & 0x8080808080808080ULL;
+        return bad ? __builtin_ctzll(bad) / 8 : 8;
+    }
+    // value of 8 digits in chunk:
+    inline uint32_t parse8(uint64_t chunk) {
+        chunk -= 0x3030303030303030ULL;
+        chunk = (chunk * 10 + (chunk >> 8)) & 0x00FF00FF00FF00FFULL;
+        chunk = (chunk * 100 + (chunk >> 16)) & 0x0000FFFF0000FFFFULL;
+        chunk = (chunk * 10000 + (chunk >> 32)) & 0x00000000FFFFFFFFULL;
+        return uint32_t(chunk);
+    }
+    // appends digits from [p, limit) to answ, returns pointer after the last digit:
+    template<typename T> const char* parseDigits(const char* p, const char* limit, T& answ) {
+        static const uint32_t pow10[9] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000};
+        while (limit - p >= 8) {
+            uint64_t chunk; std::memcpy(&chunk, p, 8);
+            const int len = digitCount8(chunk);
+            if (len == 0) { return p; }
+            if (len < 8) { chunk = (chunk << (64 - 8 * len)) | (0x3030303030303030ULL >> (8 * len)); }
+            answ = answ * T(pow10[len]) + T(parse8(chunk));
+            p += len;
+            if (len < 8) { return p; }
+        }
+        while (p < limit && '0' <= *p && *p <= '9') { (answ *= 10) += (*p++ - '0'); }
+        return p;
+    }
+    // chars which can continue real number with previous char prev:
+    inline bool isRealChar(char c, char prev) {
+        return ('0' <= c && c <= '9') || c == '.' || c == 'e' || c == 'E'
+            || ((c == '-' || c == '+') && (prev == 'e' || prev == 'E'));
+    }
+    
+    /**
+     *  AsyncChannel - background I/O thread for async mode of Reader and Writer, blocks
+     *  of bytes circulate between the owner and the thread (`count` blocks in total).
+     *  Input: the thread reads free blocks by fread, the owner takes filled ones.
+     *  Output: the owner passes filled blocks, the thread writes them by fwrite.
+     *  The thread reads ahead from construction. fread on a regular file always returns,
+     *  so for regular files (and output) the destructor joins the thread and the file can
+     *  be closed right after. On a stream which is never closed (terminal, open pipe) the
+     *  thread may be blocked in fread forever, so there it is detached: state is shared
+     *  with the thread, which exits after its current fread (bytes read ahead are
+     *  dropped), and such stream must stay open while the thread is in fread (stdin).
+     *  Output channel waits until all blocks are written.
+     */
+    struct AsyncChannel {
+    private:
+        struct State {
+            FILE* file; bool input, eof, stop, busy; size_t blockSize;
+            std::deque<std::vector<char>> ready, spare;
+            std::mutex mutex; std::condition_variable cv;
+        };
+        std::shared_ptr<State> state; std::thread worker; bool detached;
+        // input from stream other than regular file: fread may block until it is closed
+        static bool mayBlock(FILE* file) {
+        #ifdef FASTIO_MMAP
+            struct stat st;
+            return fstat(fileno(file), &st) != 0 || !S_ISREG(st.st_mode);
+        #else
+            (void)file;
+            return true;
+        #endif
+        }
+        static void run(std::shared_ptr<State> st) {
+            std::unique_lock<std::mutex> lock(st->mutex);
+            while (true) {
+                st->cv.wait(lock, [&]{ return st->stop || !(st->input ? st->spare : st->ready).empty(); });
+                if (st->input ? st->stop : st->ready.empty()) { return; }
+                auto& from = (st->input ? st->spare : st->ready);
+                auto block = std::move(from.front()); from.pop_front();
+                st->busy = true;
+                lock.unlock();
+                if (st->input) {
+                    block.resize(st->blockSize);
+                    block.resize(fread(block.data(), 1, st->blockSize, st->file));
+                } else {
+                    fwrite(block.data(), 1, block.size(), st->file);
+                    block.clear();
+                }
+                lock.lock();
+                st->busy = false;
+                const bool last = st->input && block.empty();
+                (st->input ? st->ready : st->spare).push_back(std::move(block));
+                st->cv.notify_all();
+                if (last) { return; }
+            }
+        }
+    public:
+        AsyncChannel(FILE* file_, bool input_, size_t blockSize_, int count = 3)
+            : state(new State{file_, input_, false, false, false, blockSize_, {}, {}, {}, {}}),
+              detached(input_ && mayBlock(file_))
+        {
+            // one more block is held by the owner
+            for (int i = 1; i < count; i++) { state->spare.emplace_back(); }
+            worker = std::thread(&AsyncChannel::run, state);
+        }
+        AsyncChannel(const AsyncChannel&) = delete;
+        AsyncChannel& operator=(const AsyncChannel&) = delete;
+        ~AsyncChannel() {
+            { std::lock_guard<std::mutex> lock(state->mutex); state->stop = true; }
+            state->cv.notify_all();
+            if (detached) { worker.detach(); }
+            else { worker.join(); }
+        }
+        // gives away used block, returns the next one: filled block for input (empty at the
+        // end of input) or free block for output
+        std::vector<char> exchange(std::vector<char>&& block) {
+            std::unique_lock<std::mutex> lock(state->mutex);
+            if (state->input && state->eof) { return {}; }
+            (state->input ? state->spare : state->ready).push_back(std::move(block));
+            state->cv.notify_all();
+            auto& from = (state->input ? state->ready : state->spare);
+            state->cv.wait(lock, [&]{ return !from.empty(); });
+            auto next = std::move(from.front()); from.pop_front();
+            state->eof = state->input && next.empty();
+            return next;
+        }
+        // waits until all passed blocks are written
+        void sync() {
+            std::unique_lock<std::mutex> lock(state->mutex);
+            state->cv.wait(lock, [&]{ return state->ready.empty() && !state->busy; });
+            fflush(state->file);
+        }
+    };
+    
     struct Reader {
     private:
         FILE* file; std::vector<char> buffer; int pos; bool was;
+        std::unique_ptr<AsyncChannel> channel;
         void read() {
             if (!buffer.empty()) {
-                buffer.resize(fread(&buffer[0], 1, (int)buffer.size(), file)); pos = 0; 
+                if (channel) { buffer = channel->exchange(std::move(buffer)); }
+                else { buffer.resize(fread(&buffer[0], 1, (int)buffer.size(), file)); }
+                pos = 0;
             }
         }
     public:
-        Reader(FILE* file_ = stdin, const int size_ = 1 << 16)
-            : file(file_), buffer(size_, '\0'), pos(size_), was(true) { }
+        // async: next blocks are read by background thread while current one is parsed
+        Reader(FILE* file_ = stdin, const int size_ = 1 << 16, const bool async = false)
+            : file(file_), buffer(size_, '\0'), pos(size_), was(true),
+              channel(async ? new AsyncChannel(file_, true, size_) : nullptr) { }
         operator bool() const { return was; }
         char getChar() {
             if (pos == (int)buffer.size()) { read(); }
@@ -42,52 +192,378 @@ namespace FastIO {
             if (c == '-') { positive = false; c = getChar(); }
             T answ(0);
             bool flag = false;
-            while ('0' <= c && c <= '9') { flag = true; (answ *= 10) += (c - '0'); c = getChar(); }
+            if ('0' <= c && c <= '9') {
+                // digits inside buffer are parsed in place, the rest char by char
+                flag = true; answ = T(c - '0');
+                pos = int(parseDigits(buffer.data() + pos, buffer.data() + buffer.size(), answ) - buffer.data());
+                c = getChar();
+            }
+            while ('0' <= c && c <= '9') { (answ *= 10) += (c - '0'); c = getChar(); }
             was = flag;
             return positive ? answ : -answ;
         }
+        // correctly rounded, by std::from_chars on token of at most 512 chars:
         template<typename T> T getReal() {
-            bool flag = false;
             char c = '?';
             while (!(c == '-' || ('0' <= c && c <= '9') || c == EOF)) { c = getChar(); }
-            bool positive = (c != '-');
-            if (c == '-') { c = getChar(); }
-            long long first = 0;
-            while ('0' <= c && c <= '9') { flag = true; (first *= 10) += (c - '0'); c = getChar(); }
-            was = flag;
-            if (c != '.') { return T(positive ? first : -first); }
-            c = getChar();
-            long long second = 0, pow = 1;
-            while ('0' <= c && c <= '9') { (second *= 10) += (c - '0'); c = getChar(); pow *= 10; }
-            T answ = first + (T)second / (T)pow;
+            char token[512]; int len = 0;
+            if (c == '-') { token[len++] = c; c = getChar(); }
+            while (len < 512 && isRealChar(c, len ? token[len-1] : ' ')) { token[len++] = c; c = getChar(); }
+            T answ(0);
+            was = (std::from_chars(token, token + len, answ).ec == std::errc());
+            return answ;
+        }
+        // reads up to out.size() integers, returns number of integers read; numbers inside
+        // of block are parsed on local pointer, only ones on its border go char by char
+        template<typename T> size_t readInts(std::span<T> out) {
+            auto isDigit = [](char c) { return '0' <= c && c <= '9'; };
+            size_t i = 0;
+            while (i < out.size()) {
+                const char *p = buffer.data() + pos, *e = buffer.data() + buffer.size();
+                while (i < out.size()) {
+                    while (p < e && !(*p == '-' || isDigit(*p))) { p++; }
+                    const char* q = p + (p < e && *p == '-');
+                    if (q >= e) { break; }
+                    // '-' without digits is not a number, scanning goes on after it
+                    if (!isDigit(*q)) { p = q; continue; }
+                    T answ(0);
+                    const char* r = parseDigits(q, e, answ);
+                    if (r == e) { break; }
+                    out[i++] = (p == q ? answ : -answ);
+                    p = r;
+                }
+                pos = int(p - buffer.data());
+                if (i == out.size()) { break; }
+                // number on the border of block, or the end of input:
+                char c = getChar();
+                while (true) {
+                    while (!(c == '-' || isDigit(c) || c == EOF)) { c = getChar(); }
+                    if (c == EOF) { was = false; return i; }
+                    const bool positive = (c != '-');
+                    if (!positive) { c = getChar(); if (!isDigit(c)) { continue; } }
+                    T answ(0);
+                    while (isDigit(c)) { (answ *= 10) += (c - '0'); c = getChar(); }
+                    out[i++] = positive ? answ : -answ;
+                    break;
+                }
+                // char after the number stays unread
+                pos -= (c != EOF);
+            }
+            was = true;
+            return out.size();
+        }
+    };
+    
+    /**
+     *  MappedFile - regular file mapped read-only over anonymous zero pages, so at least
+     *  one zero page follows the data (sentinel and padding for 8-byte loads).
+     *  data == nullptr if input can't be mapped: pipe, terminal, empty file or no mmap.
+     */
+    struct MappedFile {
+    private:
+        void* base; size_t mapped;
+    public:
+        char* data; size_t size;
+        MappedFile(FILE* file) : base(nullptr), mapped(0), data(nullptr), size(0) {
+        #ifdef FASTIO_MMAP
+            struct stat st;
+            const int fd = fileno(file);
+            if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0) { return; }
+            const size_t page = (size_t)sysconf(_SC_PAGESIZE), len = (size_t)st.st_size;
+            const size_t total = (len / page + 2) * page;
+            void* ptr = mmap(nullptr, total, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (ptr == MAP_FAILED) { return; }
+            // pages are faulted in while parsing, MADV_SEQUENTIAL makes kernel read ahead
+            if (mmap(ptr, len, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) { munmap(ptr, total); return; }
+            madvise(ptr, total, MADV_SEQUENTIAL);
+            base = ptr; mapped = total; data = (char*)ptr; size = len;
+        #else
+            (void)file;
+        #endif
+        }
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        ~MappedFile() {
+        #ifdef FASTIO_MMAP
+            if (mapped) { munmap(base, mapped); }
+        #endif
+        }
+        explicit operator bool() const { return data != nullptr; }
+    };
+    
+    /**
+     *  MmapReader - the same interface as Reader, but regular files are mapped into memory
+     *  and parsed in place, one zero byte after the end of data is a sentinel, so there
+     *  are no bounds checks inside numbers. Pipes and terminals (or systems without mmap)
+     *  are read by blocks into buffer with the same sentinel, before parsing of number
+     *  buffer is refilled to contain at least MaxNumber bytes (or rest of input).
+     */
+    struct MmapReader {
+    private:
+        static const int MaxNumber = 64, MaxReal = 512, Padding = 16;
+        FILE* file; std::vector<char> buffer; const char *cur, *end; bool was, eof;
+        MappedFile mapping;
+        // keeps unread bytes, reads next block, returns false if nothing was read:
+        bool refill() {
+            if (eof) { return false; }
+            const size_t rest = size_t(end - cur);
+            std::memmove(&buffer[0], cur, rest);
+            const size_t got = fread(&buffer[rest], 1, buffer.size() - Padding - rest, file);
+            eof = (got == 0);
+            buffer[rest + got] = '\0'; cur = &buffer[0]; end = cur + rest + got;
+            return got > 0;
+        }
+        void ensure(size_t k) { if (size_t(end - cur) < k) { refill(); } }
+    public:
+        MmapReader(FILE* file_ = stdin, const int size_ = 1 << 16)
+            : file(file_), cur(nullptr), end(nullptr), was(true), eof(false), mapping(file_)
+        {
+            if (mapping) {
+                cur = mapping.data; end = cur + mapping.size; eof = true;
+            } else {
+                buffer.assign(std::max(size_, 2 * MaxReal) + Padding, '\0');
+                cur = end = &buffer[0];
+            }
+        }
+        operator bool() const { return was; }
+        char getChar() {
+            if (cur == end && !refill()) { was = false; return EOF; }
+            was = true; return *cur++;
+        }
+        std::string getStr() {
+            char c = ' ';
+            while (std::isspace(c)) { c = getChar(); }
+            std::string answ;
+            while (c != EOF && !std::isspace(c)) { answ.push_back(c); c = getChar(); }
+            was = !answ.empty();
+            return answ;
+        }
+        std::string getLine() {
+            char c = '\n';
+            while (c == '\n') { c = getChar(); }
+            std::string answ;
+            while (c != '\n' && c != EOF) { answ.push_back(c); c = getChar(); }
+            was = !answ.empty();
+            return answ;
+        }
+        // skips bytes before number, returns false at the end of input:
+        bool skipToNumber(size_t maxLen = MaxNumber) {
+            while (true) {
+                const char c = *cur;
+                if (c == '-' || ('0' <= c && c <= '9')) { ensure(maxLen); return true; }
+                if (cur == end) { if (!refill()) { return false; } }
+                else { cur++; }
+            }
+        }
+        template<typename T> T getInt() {
+            if (!skipToNumber()) { was = false; return T(0); }
+            const bool positive = (*cur != '-');
+            cur += !positive;
+            T answ(0);
+            const char* start = cur;
+            // at least Padding bytes after the sentinel are readable, so 8-byte loads never fail
+            cur = parseDigits(cur, end + 8, answ);
+            was = (cur != start);
             return positive ? answ : -answ;
         }
+        // correctly rounded, by std::from_chars:
+        template<typename T> T getReal() {
+            if (!skipToNumber(MaxReal)) { was = false; return T(0); }
+            T answ(0);
+            const auto [ptr, ec] = std::from_chars(cur, end, answ);
+            was = (ec == std::errc());
+            cur = ptr + (ptr == cur);
+            return answ;
+        }
+        // reads up to out.size() integers, returns number of integers read;
+        // whitespace is skipped on local pointer, refill happens only near the end of buffer
+        template<typename T> size_t readInts(std::span<T> out) {
+            const char* p = cur;
+            for (size_t i = 0; i < out.size(); ) {
+                while (!(*p == '-' || ('0' <= *p && *p <= '9'))) {
+                    if (p != end) { p++; continue; }
+                    cur = p;
+                    if (!refill()) { was = false; return i; }
+                    p = cur;
+                }
+                if (end - p < MaxNumber && !eof) { cur = p; refill(); p = cur; }
+                const bool positive = (*p != '-');
+                p += !positive;
+                // '-' without digits is not a number, scanning goes on after it
+                if (!('0' <= *p && *p <= '9')) { continue; }
+                T answ(0);
+                p = parseDigits(p, end + 8, answ);
+                out[i++] = positive ? answ : -answ;
+            }
+            cur = p; was = true;
+            return out.size();
+        }
+    };
+    
+    /**
+     *  ParallelReader - reads all integers of input by several threads. Input is mapped
+     *  (pipes are read fully into memory) and split into equal parts, each moved forward
+     *  to the nearest separator. Each thread counts numbers in its part, then parses them
+     *  into its own range of one preallocated vector, so the order is the input order.
+     *  Numbers are maximal runs of digits, with '-' right before them for negative ones.
+     */
+    struct ParallelReader {
+    private:
+        static const int Padding = 16, MinPart = 1 << 20;
+        MappedFile mapping; std::vector<char> buffer; const char *begin, *end; int threads;
+        static bool isDigit(char c) { return '0' <= c && c <= '9'; }
+        template<typename F> static void runParallel(int parts, F f) {
+            std::vector<std::thread> pool;
+            for (int i = 1; i < parts; i++) { pool.emplace_back(f, i); }
+            f(0);
+            for (auto& t : pool) { t.join(); }
+        }
+        // number of digit runs, 8 bytes at a time: high bit of each byte is set for digits
+        static size_t countNumbers(const char* p, const char* e) {
+            const uint64_t ones = 0x0101010101010101ULL, high = 0x8080808080808080ULL;
+            size_t cnt = 0; uint64_t carry = 0;
+            for (; e - p >= 8; p += 8) {
+                uint64_t chunk; std::memcpy(&chunk, p, 8);
+                const uint64_t low = chunk & ~high;
+                const uint64_t digits = (low + 0x50 * ones) & ~(low + 0x46 * ones) & ~chunk & high;
+                cnt += __builtin_popcountll(digits & ~((digits << 8) | carry));
+                carry = digits >> 56;
+            }
+            bool prev = (carry != 0);
+            for (; p < e; p++) { const bool d = isDigit(*p); cnt += (d && !prev); prev = d; }
+            return cnt;
+        }
+        template<typename T> void parseNumbers(const char* p, const char* e, T* out) const {
+            while (true) {
+                while (p < e && !isDigit(*p)) { p++; }
+                if (p == e) { return; }
+                const bool negative = (p > begin && p[-1] == '-');
+                T answ(0);
+                // data is followed by at least Padding zero bytes, so 8-byte loads are safe
+                p = parseDigits(p, end + 8, answ);
+                *out++ = negative ? -answ : answ;
+            }
+        }
+    public:
+        ParallelReader(FILE* file = stdin, int threads_ = (int)std::thread::hardware_concurrency())
+            : mapping(file), begin(nullptr), end(nullptr), threads(std::max(threads_, 1))
+        {
+            if (mapping) {
+                begin = mapping.data; end = begin + mapping.size;
+            } else {
+                size_t len = 0;
+                buffer.resize(1 << 16);
+                while (true) {
+                    if (buffer.size() - len < 2 * Padding) { buffer.resize(2 * buffer.size()); }
+                    const size_t got = fread(&buffer[len], 1, buffer.size() - len - Padding, file);
+                    if (got == 0) { break; }
+                    len += got;
+                }
+                std::fill(buffer.begin() + len, buffer.end(), '\0');
+                begin = buffer.data(); end = begin + len;
+            }
+        }
+        // all integers of input in input order:
+        template<typename T> std::vector<T> readInts() {
+            const size_t size = size_t(end - begin);
+            const int parts = (int)std::max<size_t>(1, std::min<size_t>(threads, size / MinPart));
+            std::vector<const char*> bound(parts + 1, end);
+            bound[0] = begin;
+            for (int i = 1; i < parts; i++) {
+                const char* p = std::max(bound[i-1], begin + size / parts * i);
+                while (p < end && (*p == '-' || isDigit(*p))) { p++; }
+                bound[i] = p;
+            }
+            std::vector<size_t> offset(parts + 1);
+            runParallel(parts, [&](int i){ offset[i+1] = countNumbers(bound[i], bound[i+1]); });
+            std::partial_sum(offset.begin(), offset.end(), offset.begin());
+            std::vector<T> result(offset[parts]);
+            runParallel(parts, [&](int i){ parseNumbers(bound[i], bound[i+1], result.data() + offset[i]); });
+            return result;
+        }
     };
     
-    Reader& operator>>(Reader& reader, char& c) { return c = reader.getChar(), reader; }
+    template<class R> struct IsReader : std::false_type { };
+    template<> struct IsReader<Reader> : std::true_type { };
+    template<> struct IsReader<MmapReader> : std::true_type { };
+    
+    template<class R> typename std::enable_if<IsReader<R>::value, R&>::type
+    operator>>(R& reader, char& c) { return c = reader.getChar(), reader; }
     
-    Reader& operator>>(Reader& reader, std::string& s) { return s = reader.getStr(), reader; }
+    template<class R> typename std::enable_if<IsReader<R>::value, R&>::type
+    operator>>(R& reader, std::string& s) { return s = reader.getStr(), reader; }
     
-    template<class T> typename std::enable_if<std::is_floating_point<T>::value, Reader&>::type
-    operator>>(Reader& reader, T& t) { return t = reader.getReal<T>(), reader; }
+    template<class R, class T> typename std::enable_if<IsReader<R>::value && std::is_floating_point<T>::value, R&>::type
+    operator>>(R& reader, T& t) { return t = reader.template getReal<T>(), reader; }
     
-    template<class T> typename std::enable_if<std::is_integral<T>::value, Reader&>::type
-    operator>>(Reader& reader, T& t) { return t = reader.getInt<T>(), reader; }
+    template<class R, class T> typename std::enable_if<IsReader<R>::value && std::is_integral<T>::value, R&>::type
+    operator>>(R& reader, T& t) { return t = reader.template getInt<T>(), reader; }
     
-    template<class T> Reader& operator>>(Reader& reader, std::vector<T>& vec) {
-        for (auto &it : vec) { reader >> it; }
+    template<class R, class T> typename std::enable_if<IsReader<R>::value, R&>::type
+    operator>>(R& reader, std::vector<T>& vec) {
+        if constexpr (std::is_integral<T>::value && !std::is_same<T, char>::value && !std::is_same<T, bool>::value) {
+            reader.readInts(std::span<T>(vec));
+        } else {
+            for (auto &it : vec) { reader >> it; }
+        }
         return reader;
     }
     
+    /**
+     *  Formatting into char arrays: integers are written from the end two digits at
+     *  a time by table lookup, reals by std::to_chars (correctly rounded fixed
+     *  notation or shortest representation which reads back to the same value).
+     */
+    inline const char* digitPairs() {
+        static const char table[201] =
+            "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+            "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+            "8081828384858687888990919293949596979899";
+        return table;
+    }
+    // writes value before `end`, returns pointer to its first char:
+    template<typename T> char* formatInt(char* end, T value) {
+        using U = typename std::conditional_t<std::is_same<T, bool>::value,
+                                              std::type_identity<unsigned>, std::make_unsigned<T>>::type;
+        bool negative = false;
+        if constexpr (std::is_signed<T>::value) { negative = (value < 0); }
+        U u = negative ? U(0) - U(value) : U(value);
+        const char* pairs = digitPairs();
+        while (u >= 100) { end -= 2; std::memcpy(end, pairs + 2 * int(u % 100), 2); u /= 100; }
+        if (u >= 10) { end -= 2; std::memcpy(end, pairs + 2 * int(u), 2); }
+        else { *--end = char('0' + int(u)); }
+        if (negative) { *--end = '-'; }
+        return end;
+    }
+    
     struct Writer {
     private:
-        FILE* file; std::vector<char> buffer; int pos;
+        static const int MaxInt = 48;
+        FILE* file; std::vector<char> buffer; int pos, capacity;
         int defaultPrecision, defaultWidth; char defaultFill;
+        std::unique_ptr<AsyncChannel> channel;
+        void flushBuffer() {
+            if (channel) {
+                buffer.resize(pos);
+                buffer = channel->exchange(std::move(buffer));
+                buffer.resize(capacity);
+            } else {
+                fwrite(&buffer[0], 1, pos, file);
+            }
+            pos = 0;
+        }
+        // makes at least k bytes free in buffer, k <= buffer size:
+        void reserve(int k) { if (pos + k > capacity) { flushBuffer(); } }
+        void putFill(int cnt, char fill) { for (; cnt > 0; cnt--) { putChar(fill); } }
     public:
-        Writer(FILE* file_ = stdout, const int size_ = 1 << 16) 
-            : file(file_), buffer(size_, '\0'), pos(0), defaultPrecision(6), defaultWidth(0), defaultFill(' ') { }
+        // precision < 0 for reals means shortest representation
+        // async: full blocks are written by background thread while next one is formatted
+        Writer(FILE* file_ = stdout, const int size_ = 1 << 16, const bool async = false) 
+            : file(file_), buffer(std::max(size_, 2 * MaxInt), '\0'), pos(0), capacity(std::max(size_, 2 * MaxInt)),
+              defaultPrecision(6), defaultWidth(0), defaultFill(' '),
+              channel(async ? new AsyncChannel(file_, false, capacity) : nullptr) { }
         ~Writer() { flush(); }
-        void flush() { putChar(EOF); }
+        void flush() { flushBuffer(); if (channel) { channel->sync(); } }
         void setprecision(int precision) { defaultPrecision = precision; }
         void setw(int width) { defaultWidth = width; }
         void setfill(char fill) { defaultFill = fill; }
@@ -95,37 +571,51 @@ namespace FastIO {
         int getWidth() const { return defaultWidth; }
         char getFill() const { return defaultFill; }
         void putChar(char c) {
-            if (pos == (int)buffer.size() || c == EOF) { 
-                fwrite(&buffer[0], 1, pos, file); pos = 0; 
-            }
+            if (pos == capacity || c == EOF) { flushBuffer(); }
             if (c != EOF) { buffer[pos++] = c; }
         }
-        void putStr(const std::string& s) { for (auto it : s) putChar(it); }
+        void write(const char* s, int len) {
+            while (len > 0) {
+                if (pos == capacity) { flushBuffer(); }
+                const int k = std::min(len, capacity - pos);
+                std::memcpy(&buffer[pos], s, k); pos += k; s += k; len -= k;
+            }
+        }
+        void putStr(std::string_view s) { write(s.data(), (int)s.size()); }
         template<typename T> void putInt(T value, int width = 0, char fill = ' ') {
-            bool positive = !(value < 0);
-            if (value < 0) { value = -value; }
-            char buf[24]; int p = 0;
-            do { buf[p++] = char(value % 10 + '0'); value /= 10; } while (value > 0);
-            if (!positive) { buf[p++] = '-'; }
-            while (p < width) buf[p++] = fill;
-            while (p > 0) putChar(buf[--p]);
+            char buf[MaxInt]; const char* first = formatInt(buf + MaxInt, value);
+            const int len = int(buf + MaxInt - first);
+            putFill(width - len, fill);
+            reserve(MaxInt);
+            std::memcpy(&buffer[pos], first, len); pos += len;
         }
         template<typename T> void putReal(T value, int precision = 6, int width = 0, char fill = ' ') {
-            putInt((long long)value, width - precision - 1, fill);
-            value = std::abs(value-(long long)value);
-            if (precision == 0) { return; }
-            putChar('.');
-            #define PRINT_PART(cnt, pow) \
-                while (precision >= cnt) { \
-                    value *= pow; \
-                    putInt((int)value, cnt, '0'); \
-                    value -= (int)value; \
-                    precision -= cnt; \
-                }
-            PRINT_PART(6,1000000)
-            PRINT_PART(3,1000)
-            PRINT_PART(1,10)
-            #undef PRINT_PART
+            char buf[512];
+            auto res = precision < 0 ? std::to_chars(buf, buf + sizeof(buf), value)
+                                     : std::to_chars(buf, buf + sizeof(buf), value, std::chars_format::fixed, precision);
+            if (res.ec != std::errc()) { res = std::to_chars(buf, buf + sizeof(buf), value, std::chars_format::scientific, precision); }
+            const int len = int(res.ptr - buf);
+            putFill(width - len, fill);
+            write(buf, len);
+        }
+        // integers separated by sep, the buffer is checked once per integer:
+        template<typename T, size_t Extent> void writeInts(std::span<T, Extent> values, char sep = ' ') {
+            for (size_t i = 0; i < values.size(); i++) {
+                reserve(MaxInt + 1);
+                if (i > 0) { buffer[pos++] = sep; }
+                char buf[MaxInt]; const char* first = formatInt(buf + MaxInt, values[i]);
+                const int len = int(buf + MaxInt - first);
+                std::memcpy(&buffer[pos], first, len); pos += len;
+            }
+        }
+        template<typename T> void writeInts(const std::vector<T>& values, char sep = ' ') {
+            writeInts(std::span<const T>(values), sep);
+        }
+        // all arguments separated by spaces and new line:
+        template<typename... Args> void writeLine(const Args&... args) {
+            bool first = true;
+            ((first ? void(first = false) : putChar(' '), *this << args), ...);
+            putChar('\n');
         }
     };
     
@@ -133,6 +623,8 @@ namespace FastIO {
     
     Writer& operator<<(Writer& writer, const std::string& s) { return writer.putStr(s), writer; }
     
+    Writer& operator<<(Writer& writer, const char* s) { return writer.putStr(s), writer; }
+    
     template<class T> typename std::enable_if<std::is_floating_point<T>::value, Writer&>::type
     operator<<(Writer& writer, const T& t) {
         writer.putReal(t, writer.getPrecision(), writer.getWidth(), writer.getFill());
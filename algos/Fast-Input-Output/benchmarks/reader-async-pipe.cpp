@@ -0,0 +1,24 @@
+/**
+ *  Benchmark: Reader in sync and async mode on integers streamed through a pipe,
+ *  the async mode reads next blocks by background thread while current one is parsed.
+ *  Usage: seq 1 20000000 | reader-async-pipe [sync | async] [block size = 65536]
+ *  Both modes must print the same sum.
+ */
+#include "template.hpp"
+#include "timer.hpp"
+#include "fastio.hpp"
+
+int main(int argc, char **argv) {
+    const bool async = argc > 1 && std::string(argv[1]) == "async";
+    const int block = argc > 2 ? atoi(argv[2]) : 1 << 16;
+    Timer timer;
+    timer.start();
+    ll sum = 0, cnt = 0;
+    {
+        FastIO::Reader reader(stdin, block, async);
+        ll x;
+        while (reader >> x, reader) { sum += x, cnt++; }
+    }
+    timer.finish();
+    printf("%-5s block = %d: %lld numbers, %5zu ms, sum = %lld\n", async ? "async" : "sync", block, cnt, timer(), sum);
+}
@@ -0,0 +1,64 @@
+/**
+ *  Benchmark: throughput of std::cin, Reader, MmapReader (operator>> and readInts) and
+ *  ParallelReader::readInts on one file of n random 64-bit integers, some of them negative.
+ *  The file is written first and read back by each reader, so it is in page cache.
+ *  Usage: readers [file = readers.txt] [n = 10^7] [threads = hardware_concurrency]
+ *  All readers must print the same sum (modulo 2^64).
+ */
+#include "template.hpp"
+#include "timer.hpp"
+#include "fastio.hpp"
+
+template<typename F>
+void run(const char *name, const char *path, F read) {
+    FILE *file = fopen(path, "r");
+    Timer timer;
+    timer.start();
+    const ull sum = read(file);
+    timer.finish();
+    fclose(file);
+    printf("%-22s %5zu ms, sum = %llu\n", name, timer(), sum);
+}
+
+int main(int argc, char **argv) {
+    const char *path = argc > 1 ? argv[1] : "readers.txt";
+    const int n = argc > 2 ? atoi(argv[2]) : 10000000;
+    const int threads = argc > 3 ? atoi(argv[3]) : (int)std::thread::hardware_concurrency();
+    {
+        std::mt19937_64 gen(1);
+        FILE *file = fopen(path, "w");
+        for (int i = 0; i < n; i++) { fprintf(file, "%lld%c", ll(gen() >> 1) - (ll)(gen() >> 2), i % 10 == 9 ? '\n' : ' '); }
+        fclose(file);
+    }
+    run("std::cin", path, [&](FILE *) {
+        std::ifstream in(path);
+        std::cin.rdbuf(in.rdbuf());
+        std::ios_base::sync_with_stdio(false);
+        ull sum = 0; ll x;
+        while (std::cin >> x) { sum += ull(x); }
+        return sum;
+    });
+    run("Reader", path, [&](FILE *file) {
+        FastIO::Reader reader(file);
+        ull sum = 0; ll x;
+        while (reader >> x, reader) { sum += ull(x); }
+        return sum;
+    });
+    run("MmapReader >>", path, [&](FILE *file) {
+        FastIO::MmapReader reader(file);
+        ull sum = 0; ll x;
+        while (reader >> x, reader) { sum += ull(x); }
+        return sum;
+    });
+    run("MmapReader::readInts", path, [&](FILE *file) {
+        FastIO::MmapReader reader(file);
+        std::vector<ll> vec(n);
+        reader.readInts(std::span<ll>(vec));
+        return std::accumulate(vec.begin(), vec.end(), 0ULL);
+    });
+    run("ParallelReader", path, [&](FILE *file) {
+        FastIO::ParallelReader reader(file, threads);
+        const auto vec = reader.readInts<ll>();
+        return std::accumulate(vec.begin(), vec.end(), 0ULL);
+    });
+}
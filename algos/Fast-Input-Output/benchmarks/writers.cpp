@@ -0,0 +1,79 @@
+/**
+ *  Benchmark: output of n random 64-bit integers separated by spaces by printf,
+ *  std::cout, Writer::operator<< and Writer::writeInts into one file, and formatting
+ *  only by formatInt vs std::to_chars vs snprintf into a memory buffer.
+ *  Usage: writers [file = writers.txt] [n = 10^7]
+ *  All file rows must print the same file size, all memory rows the same length.
+ */
+#include "template.hpp"
+#include "timer.hpp"
+#include "fastio.hpp"
+
+template<typename F>
+void run(const char *name, const char *path, F write) {
+    Timer timer;
+    timer.start();
+    write();
+    timer.finish();
+    FILE *file = fopen(path, "r");
+    fseek(file, 0, SEEK_END);
+    printf("%-18s %5zu ms, file size = %ld\n", name, timer(), ftell(file));
+    fclose(file);
+}
+
+template<typename F>
+void format(const char *name, const std::vector<ll> &values, F toChars) {
+    std::vector<char> buffer(values.size() * 21);
+    Timer timer;
+    timer.start();
+    char *p = buffer.data();
+    for (ll x : values) { p = toChars(p, x); *p++ = ' '; }
+    timer.finish();
+    printf("%-18s %5zu ms, length = %td\n", name, timer(), p - buffer.data());
+}
+
+int main(int argc, char **argv) {
+    const char *path = argc > 1 ? argv[1] : "writers.txt";
+    const int n = argc > 2 ? atoi(argv[2]) : 10000000;
+    std::mt19937_64 gen(1);
+    std::vector<ll> values(n);
+    for (auto &it : values) { it = ll(gen() >> 1) - ll(gen() >> 2); }
+    run("printf", path, [&]() {
+        FILE *file = fopen(path, "w");
+        for (ll x : values) { fprintf(file, "%lld ", x); }
+        fclose(file);
+    });
+    run("std::cout", path, [&]() {
+        std::ofstream out(path);
+        auto old = std::cout.rdbuf(out.rdbuf());
+        std::ios_base::sync_with_stdio(false);
+        for (ll x : values) { std::cout << x << ' '; }
+        std::cout.flush();
+        std::cout.rdbuf(old);
+    });
+    run("Writer <<", path, [&]() {
+        FILE *file = fopen(path, "w");
+        {
+            FastIO::Writer writer(file);
+            for (ll x : values) { writer << x << ' '; }
+        }
+        fclose(file);
+    });
+    run("Writer::writeInts", path, [&]() {
+        FILE *file = fopen(path, "w");
+        {
+            FastIO::Writer writer(file);
+            writer.writeInts(values);
+            writer << ' ';
+        }
+        fclose(file);
+    });
+    format("formatInt", values, [](char *p, ll x) {
+        char buf[24];
+        const char *first = FastIO::formatInt(buf + 24, x);
+        std::memcpy(p, first, size_t(buf + 24 - first));
+        return p + (buf + 24 - first);
+    });
+    format("std::to_chars", values, [](char *p, ll x) { return std::to_chars(p, p + 20, x).ptr; });
+    format("snprintf", values, [](char *p, ll x) { return p + snprintf(p, 21, "%lld", x); });
+}
@@ -3,6 +3,10 @@
 #include <ext/pb_ds/assoc_container.hpp>
 #include <random>
 #include <chrono>
+#include <array>
+#include <immintrin.h>
+#include "cpufeatures.hpp"
+#include "fenwick.hpp"
 namespace algos {
 namespace hash {
     const ull hash_mod = (ull(1) << 61) - 1; // prime mod of hashing    
@@ -80,12 +84,13 @@ namespace hash {
     };
     GEN_COMPARATORS(Hash)
     std::vector<Hash> basepow{1};
-    Hash base = [](){
+    inline Hash genBase() {
         std::uniform_int_distribution<int> dist((int)1.9e9, (int)2e9);
         static std::mt19937 gen((int)std::chrono::high_resolution_clock::now().time_since_epoch().count());
         int tmp = dist(gen);
         return tmp % 2 == 0 ? tmp - 1 : tmp;
-    }();    
+    }
+    Hash base = genBase();
     
     struct PolyHash {
         
@@ -132,6 +137,314 @@ namespace hash {
         }
     };
     
+    /*******************************************************************************
+     *  Multiplication modulo 2^61-1 in 4 lanes, the same formula as Hash::operator*=
+     ******************************************************************************/
+    __attribute__((target("avx2")))
+    inline __m256i mulModAVX2(__m256i a, __m256i b) {
+        const __m256i mod = _mm256_set1_epi64x((ll)hash_mod);
+        const __m256i ha = _mm256_srli_epi64(a, 32), hb = _mm256_srli_epi64(b, 32);
+        const __m256i l = _mm256_mul_epu32(a, b), h = _mm256_mul_epu32(ha, hb);
+        const __m256i m = _mm256_add_epi64(_mm256_mul_epu32(a, hb), _mm256_mul_epu32(ha, b));
+        __m256i ret = _mm256_add_epi64(_mm256_and_si256(l, mod), _mm256_srli_epi64(l, 61));
+        ret = _mm256_add_epi64(ret, _mm256_slli_epi64(h, 3));
+        ret = _mm256_add_epi64(ret, _mm256_srli_epi64(m, 29));
+        ret = _mm256_add_epi64(ret, _mm256_srli_epi64(_mm256_slli_epi64(m, 35), 3));
+        ret = _mm256_add_epi64(ret, _mm256_set1_epi64x(1));
+        ret = _mm256_add_epi64(_mm256_and_si256(ret, mod), _mm256_srli_epi64(ret, 61));
+        ret = _mm256_add_epi64(_mm256_and_si256(ret, mod), _mm256_srli_epi64(ret, 61));
+        return _mm256_sub_epi64(ret, _mm256_set1_epi64x(1));
+    }
+    
+    // data[i+1][k] = data[i][k] * mult[k] + add(i) for i in [0, n), rows of K values:
+    template<int K, typename F>
+    __attribute__((target("avx2")))
+    void hashChainAVX2(ull* data, const std::array<Hash, K>& mult, const int n, F add) {
+        static_assert(K % 4 == 0);
+        constexpr int V = K / 4;
+        const __m256i mod = _mm256_set1_epi64x((ll)hash_mod);
+        __m256i cur[V], mul[V];
+        for (int v = 0; v < V; v++) {
+            cur[v] = _mm256_loadu_si256((const __m256i*)(data + 4 * v));
+            mul[v] = _mm256_set_epi64x((ll)mult[4*v+3].data, (ll)mult[4*v+2].data,
+                                       (ll)mult[4*v+1].data, (ll)mult[4*v].data);
+        }
+        for (int i = 0; i < n; i++) {
+            const __m256i c = _mm256_set1_epi64x((ll)add(i));
+            for (int v = 0; v < V; v++) {
+                __m256i x = _mm256_add_epi64(mulModAVX2(cur[v], mul[v]), c);
+                // values are below 2^62, so signed comparison is correct
+                x = _mm256_sub_epi64(x, _mm256_and_si256(mod, _mm256_cmpgt_epi64(x, _mm256_sub_epi64(mod, _mm256_set1_epi64x(1)))));
+                cur[v] = x;
+                _mm256_storeu_si256((__m256i*)(data + (size_t)(i+1) * K + 4 * v), x);
+            }
+        }
+    }
+    
+    /*******************************************************************************
+     *  MultiPolyHash<K> - K polynomial hashes modulo 2^61-1 with independent random
+     *  bases, collision probability of two strings of length n is about (n / 2^61)^K.
+     *  Prefix hashes are stored interleaved (pref[i * K + k]) and for K divisible by 4
+     *  are built in AVX2 lanes, 4 bases per register (runtime dispatch, scalar fallback).
+     *  Substring query returns MultiHash<K> - array of K hashes, which is comparable
+     *  and can be used as a key.
+     ******************************************************************************/
+    template<int K> using MultiHash = std::array<Hash, K>;
+    
+    template<int K>
+    struct MultiPolyHash {
+        
+        // -------- Static variables --------
+        static inline const std::array<Hash, K> bases = [](){
+            std::array<Hash, K> res;
+            for (auto &it : res) { it = genBase(); }
+            return res;
+        }();
+        static inline std::vector<ull> basepow = std::vector<ull>(K, 1); // interleaved
+        
+        // -------- Variables of class --------
+        std::vector<ull> pref; // interleaved polynomial hashes on prefix
+        
+        int size() const { return (int)pref.size() / K - 1; }
+        
+        MultiPolyHash() : pref(K, 0) {}
+        
+        // Constructor from string:
+        MultiPolyHash(const std::string& s) { build(s); }
+        
+        // Constructor from vector:
+        template<typename T> MultiPolyHash(const std::vector<T>& v) { build(v); }
+        
+        // data[i+1] = data[i] * bases + add(i) for i in [from, to):
+        template<typename F>
+        static void chain(ull* data, const int from, const int to, F add) {
+            if constexpr (K % 4 == 0) {
+                if (cpuFeatures.avx2) {
+                    hashChainAVX2<K>(data + (size_t)from * K, bases, to - from, [&](int i){ return add(from + i); });
+                    return;
+                }
+            }
+            for (int i = from; i < to; i++) {
+                const Hash c = add(i);
+                for (int k = 0; k < K; k++) {
+                    data[(size_t)(i+1) * K + k] = (Hash(data[(size_t)i * K + k]) * bases[k] + c).data;
+                }
+            }
+        }
+        
+        void build(const auto& s) {
+            const int n = (int)s.size();
+            pref.assign((size_t)(n + 1) * K, 0);
+            // Pre-calculate powers of bases:
+            const int had = (int)basepow.size() / K;
+            if (had <= n) {
+                basepow.resize((size_t)(n + 1) * K);
+                chain(basepow.data(), had - 1, n, [](int){ return ull(0); });
+            }
+            // Calculate polynomial hashes on prefix:
+            chain(pref.data(), 0, n, [&](int i){ return Hash(s[i]).data; });
+        }
+        
+        // Get hashes of [pos, pos+len-1] segment of string
+        inline MultiHash<K> operator()(const int pos, const int len) const {
+            MultiHash<K> res;
+            const ull *r = &pref[(size_t)(pos + len) * K], *l = &pref[(size_t)pos * K], *p = &basepow[(size_t)len * K];
+            for (int k = 0; k < K; k++) {
+                res[k] = Hash(r[k]) - Hash(l[k]) * Hash(p[k]);
+            }
+            return res;
+        }
+    };
+    
+    /*******************************************************************************
+     *  HashLCP<Seq> - longest common prefix and comparison of substrings of one
+     *  sequence on PolyHash: binary search of the length with equal hashes, then one
+     *  comparison of elements after it. O(log n) per query.
+     *  lcpMany(queries) runs binary searches of a batch of queries in rounds: each
+     *  round makes one branchless step for every query of the batch and prefetches
+     *  prefix hashes of its next step, so cache misses of different queries overlap
+     *  instead of being paid one after another.
+     *  Usage: HashLCP lcp(s); lcp.lcp(i, j); lcp.compare(i, lenI, j, lenJ);
+     ******************************************************************************/
+    template<typename Seq = std::string>
+    struct HashLCP {
+        
+        // -------- Variables of class --------
+        Seq s;
+        
+        PolyHash hash;
+        
+        HashLCP(const Seq& s_ = Seq()) : s(s_), hash(s_) { }
+        
+        int size() const { return hash.size(); }
+        
+        // True if [i, i+len-1] and [j, j+len-1] have equal hashes:
+        inline bool equal(const int i, const int j, const int len) const {
+            const Hash &p = basepow[len];
+            return hash.pref[i+len] - hash.pref[i] * p == hash.pref[j+len] - hash.pref[j] * p;
+        }
+        
+        // Longest common prefix of suffixes i and j, not greater than limit:
+        int lcp(const int i, const int j, int limit) const {
+            limit = std::min({limit, size() - i, size() - j});
+            if (i == j) return limit;
+            int low = 0, count = limit + 1;
+            while (count > 1) {
+                const int half = count / 2;
+                if (equal(i, j, low + half)) low += half;
+                count -= half;
+            }
+            return low;
+        }
+        
+        int lcp(const int i, const int j) const { return lcp(i, j, size()); }
+        
+        // Compare [i, i+lenI-1] with [j, j+lenJ-1], returns -1, 0 or 1:
+        int compare(const int i, const int lenI, const int j, const int lenJ) const {
+            const int common = lcp(i, j, std::min(lenI, lenJ));
+            if (common == std::min(lenI, lenJ)) return (lenI > lenJ) - (lenI < lenJ);
+            return s[i+common] < s[j+common] ? -1 : 1;
+        }
+        
+        // Longest common prefixes for all pairs of suffixes (i, j), batched:
+        std::vector<int> lcpMany(const std::vector<std::pair<int,int>>& queries) const {
+            const int q = (int)queries.size();
+            const int Batch = 32;
+            std::vector<int> res(q);
+            int low[Batch], count[Batch];
+            const Hash *pref = hash.pref.data(), *pw = basepow.data();
+            for (int from = 0; from < q; from += Batch) {
+                const int cnt = std::min(Batch, q - from);
+                int active = 0;
+                for (int k = 0; k < cnt; k++) {
+                    const auto [i, j] = queries[from+k];
+                    low[k] = 0;
+                    count[k] = (i == j ? 1 : std::min(size() - i, size() - j) + 1);
+                    active += (count[k] > 1);
+                }
+                while (active > 0) {
+                    active = 0;
+                    for (int k = 0; k < cnt; k++) {
+                        if (count[k] <= 1) continue;
+                        const auto [i, j] = queries[from+k];
+                        const int half = count[k] / 2, len = low[k] + half;
+                        const bool eq = pref[i+len] - pref[i] * pw[len] == pref[j+len] - pref[j] * pw[len];
+                        low[k] = eq ? len : low[k];
+                        count[k] -= half;
+                        if (count[k] > 1) {
+                            const int next = low[k] + count[k] / 2;
+                            __builtin_prefetch(pref + i + next);
+                            __builtin_prefetch(pref + j + next);
+                            __builtin_prefetch(pw + next);
+                            active++;
+                        }
+                    }
+                }
+                for (int k = 0; k < cnt; k++) {
+                    const auto [i, j] = queries[from+k];
+                    res[from+k] = (i == j ? size() - i : low[k]);
+                }
+            }
+            return res;
+        }
+        
+        // Sort substrings given as pairs (pos, len) in lexicographical order:
+        void sortSubstrings(std::vector<std::pair<int,int>>& subs) const {
+            std::stable_sort(subs.begin(), subs.end(), [&](const auto& a, const auto& b) {
+                return compare(a.first, a.second, b.first, b.second) < 0;
+            });
+        }
+        
+        // Suffix array: positions of suffixes in lexicographical order:
+        std::vector<int> sortSuffixes() const {
+            std::vector<int> order(size());
+            std::iota(order.begin(), order.end(), 0);
+            std::sort(order.begin(), order.end(), [&](int a, int b) {
+                return compare(a, size() - a, b, size() - b) < 0;
+            });
+            return order;
+        }
+    };
+    
+    /*******************************************************************************
+     *  DynamicPolyHash - polynomial hash of a sequence with point updates, on two
+     *  Fenwick trees of Hash: s[i] * base^(n-1-i) at position i for the sequence and
+     *  s[i] * base^i at position n-1-i for its reversed copy. Sum of segment is its
+     *  hash multiplied by a power of base, which is cancelled by inverse power, so
+     *  queries return the same values as PolyHash of the current sequence.
+     *  Time: O(log n) for set, substring hash and palindrome check, O(n) for build.
+     ******************************************************************************/
+    struct DynamicPolyHash {
+        
+        // -------- Static variables --------
+        static inline std::vector<Hash> ibasepow{1}; // powers of inverse base
+        
+        // -------- Variables of class --------
+        int n{};
+        
+        std::vector<Hash> vals; // current sequence
+        
+        Fenwick<Hash> fwd, rev;
+        
+        int size() const { return n; }
+        
+        DynamicPolyHash(int n_ = 0) { build(std::vector<Hash>(n_)); }
+        
+        // Constructor from string:
+        DynamicPolyHash(const std::string& s) { build(s); }
+        
+        // Constructor from vector:
+        template<typename T> DynamicPolyHash(const std::vector<T>& v) { build(v); }
+        
+        void build(const auto& s) {
+            n = (int)s.size();
+            // Pre-calculate powers of base and its inverse:
+            while ((int)basepow.size() <= n) {
+                basepow.push_back(basepow.back() * base);
+            }
+            static const Hash ibase = base^(-1);
+            while ((int)ibasepow.size() <= n) {
+                ibasepow.push_back(ibasepow.back() * ibase);
+            }
+            vals.assign(n, 0);
+            std::vector<Hash> f(n), r(n);
+            for (int i = 0; i < n; i++) {
+                vals[i] = s[i];
+                f[i] = vals[i] * basepow[n-1-i];
+                r[n-1-i] = vals[i] * basepow[i];
+            }
+            fwd.build(f);
+            rev.build(r);
+        }
+        
+        // Replace item on position i by value x:
+        void set(const int i, const Hash& x) {
+            assert(0 <= i && i < n);
+            const Hash delta = x - vals[i];
+            vals[i] = x;
+            fwd.inc(i, delta * basepow[n-1-i]);
+            rev.inc(n-1-i, delta * basepow[i]);
+        }
+        
+        Hash get(const int i) const { return vals[i]; }
+        
+        // Get hash from [pos, pos+len-1] segment of sequence
+        Hash operator()(const int pos, const int len) const {
+            if (len == 0) return 0;
+            return fwd.sum(pos, pos+len-1) * ibasepow[n-pos-len];
+        }
+        
+        // Get hash from reversed [pos, pos+len-1] segment of sequence
+        Hash reversed(const int pos, const int len) const {
+            if (len == 0) return 0;
+            return rev.sum(n-pos-len, n-pos-1) * ibasepow[pos];
+        }
+        
+        bool isPalindrome(const int pos, const int len) const {
+            return (*this)(pos, len) == reversed(pos, len);
+        }
+    };
+    
     struct custom_hash
     {
         static uint64_t splitmix64(uint64_t x) {
@@ -5,11 +5,13 @@
 namespace algos {
 namespace lca {
 
-struct LCA {
+// RMQ - range minimum structure over euler tour (SparseTable or LinearSparseTable)
+template<typename RMQ>
+struct LCABase {
     const int INF = (int)1e9+7;
     vi pos, pf, dep;
     vpii euler;
-    algos::SparseTable::SparseTable<pii, algos::SparseTable::Min<pii>> st;
+    RMQ st;
 
     void eulerwalk(int u, int p, const vvi &adj) {
         dep[u] = dep[p]+1;
@@ -57,6 +59,11 @@ struct LCA {
         return dist_from_poses(pos[u], pos[v]);
     }
 };
+
+using LCA = LCABase<algos::SparseTable::SparseTable<pii, algos::SparseTable::Min<pii>>>;
+
+// O(n) memory version for big trees
+using LCALinear = LCABase<algos::SparseTable::LinearSparseTable<pii, algos::SparseTable::Min<pii>>>;
 } // namespace lca
 } // namespace algos
 #endif // __LCA_HPP__
\ No newline at end of file